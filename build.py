@@ -9,6 +9,8 @@ Usage:
     python build.py --clean      Clean build artifacts
     python build.py --rebuild    Clean, build, and run
     python build.py --release    Build with optimizations
+    python build.py --cli        Build the headless batch tool (fourier_cli.exe)
+    python build.py --bench      Build and run the microbenchmarks (fourier_bench.exe)
 """
 
 import argparse
@@ -18,7 +20,7 @@ import sys
 import time
 from pathlib import Path
 from dataclasses import dataclass
-from typing import List
+from typing import List, Optional
 
 
 # =============================================================================
@@ -37,6 +39,8 @@ class BuildConfig:
     
     # Output
     exe_name: str = "Fourier.exe"
+    cli_exe_name: str = "fourier_cli.exe"
+    bench_exe_name: str = "fourier_bench.exe"
     
     # Compiler settings
     compiler: str = "cl"
@@ -45,8 +49,44 @@ class BuildConfig:
     sources: tuple = (
         "main.c",
         "fourier.c",
+        "fft.c",
+        "simd.c",
         "shapes.c",
         "ui.c",
+        "render.c",
+        "platform.c",
+        "task_pool.c",
+        "mem.c",
+        "points.c",
+        "fcoef.c",
+    )
+    
+    # Headless batch tool (no raylib)
+    cli_sources: tuple = (
+        "cli.c",
+        "fourier.c",
+        "fft.c",
+        "simd.c",
+        "shapes.c",
+        "platform.c",
+        "task_pool.c",
+        "mem.c",
+        "points.c",
+        "fcoef.c",
+    )
+    
+    # Microbenchmarks (no raylib)
+    bench_sources: tuple = (
+        "bench.c",
+        "fourier.c",
+        "fft.c",
+        "simd.c",
+        "shapes.c",
+        "platform.c",
+        "task_pool.c",
+        "mem.c",
+        "points.c",
+        "fcoef.c",
     )
     
     # Libraries
@@ -104,13 +144,20 @@ def print_info(msg: str) -> None:
 class Builder:
     """Handles compilation and build management."""
     
-    def __init__(self, config: BuildConfig, release: bool = False):
+    def __init__(self, config: BuildConfig, release: bool = False, target: str = "app"):
         self.config = config
         self.release = release
+        self.target = target
+        if target == "cli":
+            self.sources, self.exe_name = config.cli_sources, config.cli_exe_name
+        elif target == "bench":
+            self.sources, self.exe_name = config.bench_sources, config.bench_exe_name
+        else:
+            self.sources, self.exe_name = config.sources, config.exe_name
     
     def _get_source_files(self) -> List[str]:
         """Get full paths to source files."""
-        return [str(self.config.src_dir / src) for src in self.config.sources]
+        return [str(self.config.src_dir / src) for src in self.sources]
     
     def _get_compiler_flags(self) -> List[str]:
         """Get compiler flags based on build type."""
@@ -118,7 +165,7 @@ class Builder:
             self.config.compiler,
             f"/I{self.config.include_dir}",
             f"/Fo{self.config.build_dir}\\",
-            f"/Fe{self.config.build_dir}\\{self.config.exe_name}",
+            f"/Fe{self.config.build_dir}\\{self.exe_name}",
             "/nologo",  # Suppress banner
         ]
         
@@ -161,17 +208,20 @@ class Builder:
         # Create build directory
         self.config.build_dir.mkdir(exist_ok=True)
         
-        # Copy DLL
-        self._copy_dll()
+        # The batch tool and benchmarks do not link raylib
+        libs = []
+        if self.target == "app":
+            self._copy_dll()
+            libs = [str(self.config.lib_dir / self.config.raylib_lib)]
         
         # Build command
         cmd = (
             self._get_compiler_flags() +
             self._get_source_files() +
-            [str(self.config.lib_dir / self.config.raylib_lib)]
+            libs
         )
         
-        print_info(f"Compiling {len(self.config.sources)} source files...")
+        print_info(f"Compiling {len(self.sources)} source files...")
         
         start_time = time.perf_counter()
         
@@ -186,7 +236,7 @@ class Builder:
             elapsed = time.perf_counter() - start_time
             print_success(f"Build completed in {elapsed:.2f}s")
             
-            exe_path = self.config.build_dir / self.config.exe_name
+            exe_path = self.config.build_dir / self.exe_name
             size_kb = exe_path.stat().st_size / 1024
             print_info(f"Output: {exe_path} ({size_kb:.1f} KB)")
             
@@ -200,21 +250,21 @@ class Builder:
                 print(e.stderr)
             return False
     
-    def run(self) -> bool:
+    def run(self, args: Optional[List[str]] = None) -> bool:
         """Run the compiled executable."""
         print_header("Running")
         
-        exe_path = self.config.build_dir / self.config.exe_name
+        exe_path = self.config.build_dir / self.exe_name
         
         if not exe_path.exists():
             print_error(f"Executable not found: {exe_path}")
             return False
         
-        print_info(f"Launching {self.config.exe_name}...")
+        print_info(f"Launching {self.exe_name}...")
         print()
         
         try:
-            subprocess.run([str(exe_path)], check=True)
+            subprocess.run([str(exe_path)] + (args or []), check=True)
             return True
         except subprocess.CalledProcessError:
             print_error("Application exited with error")
@@ -240,6 +290,8 @@ Examples:
   python build.py --build      Build only
   python build.py --clean      Clean build artifacts
   python build.py --rebuild    Clean + build + run
+  python build.py --cli        Build fourier_cli.exe only
+  python build.py --bench      Build fourier_bench.exe and write build/bench.json
         """
     )
     
@@ -264,6 +316,16 @@ Examples:
         action="store_true",
         help="Clean, build, and run"
     )
+    actions.add_argument(
+        "--cli",
+        action="store_true",
+        help="Build the headless batch tool only"
+    )
+    actions.add_argument(
+        "--bench",
+        action="store_true",
+        help="Build and run the microbenchmarks (results in build/bench.json)"
+    )
     
     parser.add_argument(
         "--release",
@@ -280,7 +342,8 @@ def main() -> int:
     args = parse_args()
     
     config = BuildConfig()
-    builder = Builder(config, release=args.release)
+    target = "cli" if args.cli else "bench" if args.bench else "app"
+    builder = Builder(config, release=args.release or args.bench, target=target)
     
     # Handle actions
     if args.clean:
@@ -292,9 +355,15 @@ def main() -> int:
             return 1
         return 0 if builder.run() else 1
     
-    if args.build:
+    if args.build or args.cli:
         return 0 if builder.build() else 1
     
+    if args.bench:
+        if not builder.build():
+            return 1
+        out = str(config.build_dir / "bench.json")
+        return 0 if builder.run(["--out", out]) else 1
+    
     # Default: build and run
     if not builder.build():
         return 1
@@ -0,0 +1,96 @@
+/**
+ * fcoef.h - Coefficient Cache
+ *
+ * Finished transforms of loaded shapes are kept on disk, one .fcoef file
+ * per input, named after a hash of the points that were transformed. The
+ * same shape loaded again (picked, dropped, or a copy under another name)
+ * maps its file and skips the transform.
+ *
+ * File layout (native byte order, no padding):
+ *
+ *   fcoef_header_t      32 bytes
+ *   complex_t[count]    normalized spectrum, bin order (DFT output)
+ *   epicycle_t[count]   epicycles sorted as dft_to_epicycles() leaves them
+ *
+ * A file is only used when every header field matches and its size is
+ * exact; anything else (other version, other byte order, truncated write)
+ * is a miss and gets rewritten.
+ */
+
+#ifndef FCOEF_H
+#define FCOEF_H
+
+#include "fourier.h"
+#include "platform.h"
+#include <stdint.h>
+
+/* Bump when the layout or the meaning of the coefficients changes */
+#define FCOEF_VERSION      1
+
+/* Default cache directory, relative to the working directory */
+#define FCOEF_CACHE_DIR    "cache"
+
+/* Smaller inputs transform in about a millisecond; a file would not pay for itself */
+#define FCOEF_MIN_POINTS   4096
+
+/* Header flags */
+#define FCOEF_CENTERED     1u   /* Epicycles use signed frequencies */
+
+/* ========== Types ========== */
+
+typedef struct {
+    char magic[4];          /* "FCOE" */
+    uint32_t version;       /* FCOEF_VERSION */
+    uint32_t byte_order;    /* 0x01020304 as written by the producing machine */
+    uint32_t flags;         /* FCOEF_* */
+    uint64_t key;           /* fcoef_key() of the input */
+    int32_t count;          /* N: spectrum bins and epicycles */
+    uint32_t reserved;      /* 0 */
+} fcoef_header_t;
+
+/* A cache file mapped for reading; the arrays point into the mapping */
+typedef struct {
+    platform_file_map_t map;
+    int count;
+    bool centered;
+    const complex_t *spectrum;
+    const epicycle_t *epicycles;
+} fcoef_file_t;
+
+/* ========== Functions ========== */
+
+/**
+ * Cache key of a transform input: a 64-bit FNV-1a style hash of the point
+ * count and the points' bytes. Resampling and loader settings are covered
+ * because they change the points.
+ */
+uint64_t fcoef_key(const point_list_t *points);
+
+/**
+ * Map the cache file for a key, if there is a valid one.
+ *
+ * @param dir     Cache directory
+ * @param key     fcoef_key() of the input
+ * @param count   Expected N
+ * @param file    Receives the mapping (release with fcoef_close)
+ * @return        true on a hit
+ */
+bool fcoef_open(const char *dir, uint64_t key, int count, fcoef_file_t *file);
+
+/**
+ * Unmap a file opened by fcoef_open() and clear it.
+ */
+void fcoef_close(fcoef_file_t *file);
+
+/**
+ * Write the cache file for a key, creating the directory if needed. The
+ * file is written under a temporary name and moved into place, so readers
+ * never see a partial file. Safe to call from a worker thread.
+ *
+ * @return        false if the file could not be written (the cache is
+ *                best effort; callers just carry on)
+ */
+bool fcoef_store(const char *dir, uint64_t key, const complex_t *spectrum,
+                 const epicycle_t *epicycles, int count, bool centered);
+
+#endif /* FCOEF_H */
@@ -0,0 +1,146 @@
+/**
+ * fft.h - Fast Fourier Transform Engine
+ *
+ * Computes the same unnormalized transform as the DFT formula in fourier.h,
+ *
+ *   X[k] = sum_{n=0}^{N-1} x[n] * e^(-i 2*pi*k*n/N)
+ *
+ * in O(N log N) for any N:
+ *   - powers of two use an iterative radix-4 transform (plus one radix-2
+ *     pass when log2(N) is odd)
+ *   - sizes whose prime factors are all <= FFT_MAX_RADIX use a recursive
+ *     mixed-radix transform
+ *   - everything else (large primes) uses Bluestein's chirp-z algorithm
+ *
+ * All size-dependent tables (twiddles, bit-reversal permutation, chirp,
+ * scratch buffers) live in an fft_plan_t. Plans can be built directly, or
+ * taken from a small LRU cache keyed by N so repeated transforms of the
+ * same size skip table generation.
+ *
+ * Transforms of at least fft_parallel_threshold() points are spread over
+ * the task pool (task_pool.h, thread count set with task_pool_set_threads()).
+ * The parallel paths evaluate every butterfly exactly like the serial one,
+ * so results are bit-identical whatever the thread count.
+ */
+
+#ifndef FFT_H
+#define FFT_H
+
+#include "fourier.h"
+
+/* Largest prime factor handled by the mixed-radix path */
+#define FFT_MAX_RADIX    13
+
+/* Enough (radix, length) pairs for any int-sized N */
+#define FFT_MAX_FACTORS  32
+
+/* Number of plans kept by the LRU cache */
+#define FFT_PLAN_CACHE_SIZE  8
+
+/* Default size from which transforms run on the task pool */
+#define FFT_PARALLEL_MIN_N   16384
+
+/* Power of two: elements per independent block of the narrow passes (fits in L1/L2) */
+#define FFT_PARALLEL_BLOCK   4096
+
+/* Butterflies per task of a wide pass */
+#define FFT_PARALLEL_GRAIN   1024
+
+/* ========== Types ========== */
+
+typedef struct fft_plan fft_plan_t;
+
+typedef struct {
+    unsigned long long hits;        /* fft_plan_acquire() served from the cache */
+    unsigned long long misses;      /* fft_plan_acquire() had to build a plan */
+    unsigned long long evictions;   /* Cached plans dropped to make room */
+    int cached_plans;               /* Plans currently held by the cache */
+} fft_cache_stats_t;
+
+/* ========== Plans ========== */
+
+/**
+ * Build a plan for transforms of length n. Owned by the caller.
+ *
+ * @param n     Transform length (> 0)
+ * @return      New plan, or NULL on bad size / allocation failure
+ */
+fft_plan_t *fft_plan_create(int n);
+
+/**
+ * Free a plan created with fft_plan_create(). Accepts NULL.
+ */
+void fft_plan_destroy(fft_plan_t *plan);
+
+/**
+ * Get the transform length a plan was built for.
+ */
+int fft_plan_size(const fft_plan_t *plan);
+
+/**
+ * Run the forward transform described by a plan (no 1/N normalization).
+ * Uses the plan's scratch buffers, so a plan must not be executed by two
+ * callers at once.
+ *
+ * @param plan  Plan of length N
+ * @param in    Input samples (N values, not modified)
+ * @param out   Output spectrum (N values, must not alias `in`)
+ */
+void fft_execute(const fft_plan_t *plan, const complex_t *in, complex_t *out);
+
+/* ========== Threading ========== */
+
+/**
+ * Set the smallest transform length that runs multi-threaded. Shorter
+ * transforms stay on the calling thread, where pool handoff would cost
+ * more than it saves.
+ *
+ * @param n     Threshold in points; 0 or less disables threading
+ */
+void fft_set_parallel_threshold(int n);
+
+/**
+ * Get the current threading threshold.
+ */
+int fft_parallel_threshold(void);
+
+/* ========== Plan Cache ========== */
+
+/**
+ * Get a plan of length n from the LRU cache, building it on a miss.
+ * Every acquired plan must be handed back with fft_plan_release().
+ *
+ * @param n     Transform length (> 0)
+ * @return      Plan, or NULL on bad size / allocation failure
+ */
+fft_plan_t *fft_plan_acquire(int n);
+
+/**
+ * Return a plan obtained from fft_plan_acquire(). Accepts NULL.
+ */
+void fft_plan_release(fft_plan_t *plan);
+
+/**
+ * Get the cache hit/miss counters.
+ */
+fft_cache_stats_t fft_cache_stats(void);
+
+/**
+ * Free every cached plan that is not currently acquired and reset the counters.
+ */
+void fft_cache_clear(void);
+
+/* ========== One-Shot Transform ========== */
+
+/**
+ * Compute the forward FFT of `in` into `out` (no 1/N normalization),
+ * using a cached plan.
+ *
+ * @param in    Input samples (N values, not modified)
+ * @param out   Output spectrum (N values, must not alias `in`)
+ * @param n     Transform length
+ * @return      true on success, false on bad arguments or allocation failure
+ */
+bool fft_forward(const complex_t *in, complex_t *out, int n);
+
+#endif /* FFT_H */
@@ -49,21 +49,47 @@
 #define FOURIER_H
 
 #include "raylib.h"
+#include "points.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <math.h>
 
 #define WINDOW_WIDTH  1400
 #define WINDOW_HEIGHT 1000
 #define WINDOW_TITLE  "Fourier Animator"
 
-#define DRAWING_POINTS_MAX  5000
-
 /* Shape loading constants */
 #define DEFAULT_SHAPE_SIZE    250.0f
 #define DEFAULT_LOAD_SCALE    500.0f
 #define DEFAULT_SHAPE_POINTS  500
 
+/* Arc-length resampling of the input before the transform */
+#define RESAMPLE_MIN_POINTS      64
+#define RESAMPLE_MAX_POINTS      (1 << 20)
+#define DEFAULT_RESAMPLE_POINTS  1024   /* M for RESAMPLE_FIXED until the user picks one */
+
+/* Loads with at least this many points are transformed on a worker thread */
+#define ASYNC_TRANSFORM_MIN_POINTS  4096
+
+/* Online transform of freehand input: smallest grid, and growth when points outrun it */
+#define ONLINE_DFT_MIN_SIZE   64
+#define ONLINE_DFT_GROWTH     16     /* Regrow to at least N + N / ONLINE_DFT_GROWTH */
+
+/* Samples of the quick preview animated while a background transform runs (power of two) */
+#define PROGRESSIVE_PREVIEW_POINTS  1024
+
+/* Incremental epicycle evaluator */
+#define EVAL_RENORM_INTERVAL  64     /* Steps between arm magnitude re-normalizations */
+#define EVAL_RESEED_INTERVAL  1024   /* Steps between exact re-seeds (bounds phase drift) */
+
+/* Fixed-step animation clock */
+#define ANIMATION_STEP_TIME   (1.0f / 60.0f)  /* Simulated seconds per trace step at 1x speed */
+#define ANIMATION_MAX_STEPS   32              /* Steps run per frame at most; older backlog is dropped */
+
+/* Term budget: fraction of (non-DC) spectral energy kept by default */
+#define DEFAULT_ENERGY_FRACTION  0.999f
+
 /* File browser constants */
 #define MAX_SHAPE_FILES    20
 #define MAX_FILENAME_LEN   64
@@ -81,23 +107,156 @@ typedef struct {
     float phase;
 } epicycle_t;
 
+/**
+ * Stateful epicycle evaluator for a fixed time step dt.
+ *
+ * Each arm is kept as the vector amplitude * e^(i*(frequency*t + phase))
+ * and advanced by one complex multiply with e^(i*frequency*dt) per step,
+ * instead of calling cosf/sinf for every term every frame.
+ */
+typedef struct {
+    int count;           /* Number of epicycles tracked */
+    int capacity;        /* Allocated entries per array */
+    int step;            /* Current step index, t = step * dt */
+    int steps_since_renorm;
+    int steps_since_seed;
+    float dt;
+    float *amplitude;
+    float *arm_x;        /* Current arm vectors */
+    float *arm_y;
+    float *rot_x;        /* Per-step rotation e^(i*frequency*dt) */
+    float *rot_y;
+    const epicycle_t *epic;
+} epicycle_eval_t;
+
+/**
+ * Structure-of-arrays copy of the leading epicycles, summed several terms
+ * at a time by the kernels in simd.h. Arrays are padded to SIMD_LANES.
+ */
+typedef struct {
+    int count;          /* Real terms */
+    int padded;         /* count rounded up to SIMD_LANES (extra terms have amplitude 0) */
+    int capacity;       /* Allocated entries per array */
+    float *frequency;
+    float *amplitude;
+    float *phase;       /* In turns: phase / (2*pi) */
+} epicycle_soa_t;
+
+/**
+ * Fixed-timestep scheduler. Frame time (scaled by speed) accumulates and
+ * is consumed in whole steps, so the animation keeps its requested pace
+ * however many steps a frame has to cover. The remainder gives the
+ * interpolation factor between the current step and the next.
+ */
+typedef struct {
+    float step_time;     /* Simulated time per step */
+    int max_steps;       /* Steps granted per advance at most */
+    float accumulator;   /* Time not yet consumed; below step_time after each advance */
+    int last_steps;      /* Steps granted by the last advance */
+    int stalls;          /* Advances whose backlog exceeded max_steps (time was dropped) */
+} step_clock_t;
+
+typedef struct {
+    double real;
+    double imag;
+} complex_d_t;
+
+/**
+ * Online transform of a growing point list. A DFT's length changes with
+ * every point, which changes every twiddle, so the exact N-point spectrum
+ * cannot be updated in place. Instead the points are accumulated on a
+ * fixed grid of L >= N samples:
+ *
+ *   A[k] = sum_{n<N} x[n] * W_L^(k*n),   W_L = e^(-2*pi*i/L)
+ *
+ * A new point costs one multiply-add per bin. When N outgrows L, the grid
+ * is regrown by about 1/ONLINE_DFT_GROWTH to a 2-3-5-smooth length and A
+ * is rebuilt with one FFT, which amortizes to O(log L) per point. The
+ * spectrum read out closes the drawing with a straight segment over the
+ * L - N spare samples (added in closed form, O(1) per bin) and divides by
+ * L. Nothing in it depends on N beyond that final scale, so it is always
+ * ready to use.
+ */
+typedef struct {
+    int count;              /* Points accumulated (N) */
+    int size;               /* Grid length L (0 = empty) */
+    int capacity;           /* Allocated entries per array */
+    complex_d_t *acc;       /* A[k], k = 0..L-1 */
+    complex_d_t *twiddles;  /* W_L^j, j = 0..L-1 */
+    int regrows;            /* Grid rebuilds since the last reset */
+} online_dft_t;
+
+/**
+ * How many evenly spaced samples the input is resampled to before the
+ * transform. Loaders and freehand drawing sample at arbitrary density
+ * (one point per line segment, a fixed count per curve, one per frame),
+ * which wastes terms on over-sampled straight runs; resampling by arc
+ * length fixes the density and picks the transform size.
+ */
+typedef enum {
+    RESAMPLE_OFF,           /* Transform the points as loaded or drawn */
+    RESAMPLE_POW2,          /* Power of two nearest the point count (fastest FFT size) */
+    RESAMPLE_FIXED          /* The user's resample_points */
+} resample_mode_t;
+
+/* Background transform job (opaque, see app_start_animation_async) */
+typedef struct transform_job transform_job_t;
+
+typedef enum {
+    TRANSFORM_IDLE,         /* No background transform */
+    TRANSFORM_RUNNING,
+    TRANSFORM_DONE,         /* Published into the state */
+    TRANSFORM_FAILED,
+    TRANSFORM_CANCELLED
+} transform_status_t;
+
 /* ========== Application State ========== */
 
 typedef struct {
-    /* Drawing state */
-    Vector2 drawing_points[DRAWING_POINTS_MAX];
-    Vector2 trace_points[DRAWING_POINTS_MAX];
-    int point_count;
-    int trace_count;
+    /* Drawing state (point lists grow in the session arena, released by app_reset) */
+    mem_arena_t arena;
+    point_list_t drawing_points;
+    point_list_t trace_points;
     
-    /* Fourier data */
+    /* Fourier data (caller-owned buffers, reused across runs and grown geometrically) */
+    complex_t  *dft_input;
     complex_t  *dft_result;
     epicycle_t *epicycles;
+    int dft_input_capacity;
+    int dft_result_capacity;
+    int epicycles_capacity;
+    int spectrum_size;     /* N of the current transform (0 = none) */
+    int total_steps;       /* Trace steps per cycle: the input's point count */
+    bool preview;          /* Spectrum is a decimated, always centered preview; the full one is computing */
+    epicycle_eval_t eval;  /* Per-arm positions for drawing */
+    epicycle_soa_t soa;    /* Same terms, summed by the SIMD kernel for the trace */
+    float energy_fraction; /* Energy kept by the term budget (0..1) */
+    bool centered_freqs;   /* Map bins above N/2 to negative frequencies k - N */
+    int active_terms;      /* Leading epicycles evaluated and drawn */
+    int last_start_allocs; /* Heap allocations made by the last app_start_animation() */
+    
+    /* Arc-length resampling applied to the input by app_resample_input() */
+    resample_mode_t resample_mode;
+    int resample_points;   /* M for RESAMPLE_FIXED */
+    point_list_t resample_scratch;  /* Session arena; swapped with drawing_points */
+    
+    /* Online transform of freehand input, fed while the user draws */
+    online_dft_t online;
+    bool online_transform; /* Use it when a drawing ends (else a full transform on release) */
+    
+    /* Coefficient cache (see fcoef.h) */
+    const char *coef_cache_dir;     /* NULL = no cache */
+    uint64_t cache_key;    /* Input of the next full transform, stored once it finishes (0 = none) */
+    
+    /* Background transform: in flight, superseded (joined once they stop), kept for reuse */
+    transform_job_t *transform;
+    transform_job_t *retired_transforms;
+    transform_job_t *spare_transform;
     
     /* Animation state */
     float t;
     float speed;
-    float frame_time;
+    step_clock_t clock;
     float line_thickness;
     int current_k;
     int color_index;      /* Index into color presets */
@@ -124,9 +283,170 @@ float     complex_magnitude(complex_t *a);
 float     complex_phase(complex_t *a);
 
 complex_t  *DFT(complex_t *arr, int N);
-epicycle_t *dft_to_epicycles(complex_t *dft, int N);
+epicycle_t *dft_to_epicycles(complex_t *dft, int N, bool centered);
 Vector2     epicycles_position(epicycle_t *epic, int N, float t);
-Vector2     draw_epicycles(epicycle_t *epic, int N, float t, float line_thickness);
+
+/**
+ * Allocation-free forms of DFT() and dft_to_epicycles(): results go to
+ * caller-owned arrays of N entries. DFT() and dft_to_epicycles() are
+ * wrappers that allocate the result.
+ *
+ * @param in/dft    Input samples / normalized spectrum (N entries)
+ * @param out       Output array (N entries, must not alias the input)
+ * @return          dft_into: false on bad size or allocation failure
+ *                  (first use of a size builds an FFT plan)
+ */
+bool dft_into(const complex_t *in, complex_t *out, int N);
+void dft_to_epicycles_into(const complex_t *dft, epicycle_t *out, int N, bool centered);
+
+/**
+ * dft_to_epicycles() turns bin k into an epicycle spinning at frequency k.
+ * With `centered`, bins above N/2 spin backwards at k - N instead. Both
+ * agree at the sample instants t = 2*pi*n/N, but the centered spectrum
+ * is the smoothest curve through the samples, so it needs far fewer
+ * terms for the same picture and can be evaluated between samples.
+ */
+
+/**
+ * Number of leading epicycles needed to keep a fraction of the spectral energy.
+ * Expects the order produced by dft_to_epicycles() (DC first, then by
+ * descending amplitude); the DC term is always kept and does not count
+ * toward the energy total.
+ *
+ * @param epic      Sorted epicycles
+ * @param N         Number of epicycles
+ * @param fraction  Energy to keep (0..1); values >= 1 keep every term
+ * @return          Term count K (1..N)
+ */
+int epicycles_terms_for_energy(const epicycle_t *epic, int N, float fraction);
+
+/* ========== Incremental Evaluator ========== */
+
+/**
+ * Initialize an empty evaluator (no allocations).
+ */
+void epicycle_eval_init(epicycle_eval_t *ev);
+
+/**
+ * Bind an evaluator to a set of epicycles and a fixed time step, then seed it at t = 0.
+ * Buffers are reused when they are already large enough.
+ *
+ * @param ev      Evaluator
+ * @param epic    Epicycles (must stay valid while the evaluator is used)
+ * @param N       Number of epicycles
+ * @param dt      Time advanced by one step
+ * @return        false on allocation failure
+ */
+bool epicycle_eval_setup(epicycle_eval_t *ev, const epicycle_t *epic, int N, float dt);
+
+/**
+ * Recompute every arm exactly (cosf/sinf) at t = step * dt.
+ */
+void epicycle_eval_seed(epicycle_eval_t *ev, int step);
+
+/**
+ * Advance every arm by one time step.
+ */
+void epicycle_eval_step(epicycle_eval_t *ev);
+
+/**
+ * Bring the evaluator to time t: one incremental step when t is the next
+ * step, otherwise (restart, jumps) an exact re-seed.
+ */
+void epicycle_eval_sync(epicycle_eval_t *ev, float t);
+
+/**
+ * Sum of all arms (the tip position) at the current step.
+ */
+Vector2 epicycle_eval_position(const epicycle_eval_t *ev);
+
+/**
+ * Free the evaluator's buffers.
+ */
+void epicycle_eval_free(epicycle_eval_t *ev);
+
+/* ========== Online Transform ========== */
+
+/**
+ * Initialize an empty online transform (no allocations).
+ */
+void online_dft_init(online_dft_t *od);
+
+/**
+ * Accumulate the points added since the last call (points->data[od->count..]).
+ * A list that got shorter than what was accumulated starts over.
+ *
+ * @param od        Online transform
+ * @param points    Growing input
+ * @return          false on allocation failure (the transform is then reset)
+ */
+bool online_dft_update(online_dft_t *od, const point_list_t *points);
+
+/**
+ * Normalized spectrum of the accumulated points, closed with a straight
+ * segment from the last point back to the first over the spare grid
+ * samples.
+ *
+ * @param od        Online transform (count > 0)
+ * @param points    The same input, for the closing segment's end points
+ * @param out       od->size bins
+ */
+void online_dft_spectrum(const online_dft_t *od, const point_list_t *points, complex_t *out);
+
+/**
+ * Forget every point (buffers are kept).
+ */
+void online_dft_reset(online_dft_t *od);
+
+/**
+ * Free the online transform's buffers.
+ */
+void online_dft_free(online_dft_t *od);
+
+/* ========== Resampling ========== */
+
+/**
+ * Sample count the input is resampled to under a policy, clamped to
+ * RESAMPLE_MIN_POINTS..RESAMPLE_MAX_POINTS.
+ *
+ * @param mode      Policy
+ * @param n         Input point count
+ * @param fixed     M for RESAMPLE_FIXED
+ * @return          M, or 0 when the input is used as is
+ */
+int resample_target(resample_mode_t mode, int n, int fixed);
+
+/* ========== Step Clock ========== */
+
+/**
+ * Initialize a clock with no pending time.
+ *
+ * @param clock      Clock
+ * @param step_time  Simulated time per step (> 0)
+ * @param max_steps  Cap on steps per advance (>= 1)
+ */
+void step_clock_init(step_clock_t *clock, float step_time, int max_steps);
+
+/**
+ * Drop pending time and the stall count (new run).
+ */
+void step_clock_reset(step_clock_t *clock);
+
+/**
+ * Add elapsed time and take the whole steps it covers. When more than
+ * max_steps are due (a stalled frame, a window drag), the extra backlog
+ * is discarded and counted as a stall instead of being carried forward.
+ *
+ * @param clock      Clock
+ * @param elapsed    Simulated time since the last advance (frame time * speed)
+ * @return           Steps to run now (0..max_steps)
+ */
+int step_clock_advance(step_clock_t *clock, float elapsed);
+
+/**
+ * Fraction of the next step already elapsed (0..1), for interpolation.
+ */
+float step_clock_alpha(const step_clock_t *clock);
 
 /* ========== Application State Functions ========== */
 
@@ -135,9 +455,22 @@ Vector2     draw_epicycles(epicycle_t *epic, int N, float t, float line_thicknes
  */
 void app_state_init(AppState *state);
 
+/**
+ * Replace the drawing points with the resampled path the state's policy
+ * asks for (see resample_target). Run it between loading and starting the
+ * animation. The result is built in a scratch list in the session arena
+ * and swapped with the drawing, so a warm state does not allocate.
+ *
+ * @param state   Application state
+ * @return        true if the drawing was resampled
+ */
+bool app_resample_input(AppState *state);
+
 /**
  * Start the Fourier animation from the current drawing points.
- * Computes DFT and sets up epicycles.
+ * Computes DFT and sets up epicycles in the state's reusable buffers; once
+ * they have grown to the largest N seen (and the FFT plan for N is cached),
+ * this makes no heap allocations (see last_start_allocs).
  * 
  * @param state   Application state
  * @return        true if animation started successfully
@@ -145,8 +478,104 @@ void app_state_init(AppState *state);
 bool app_start_animation(AppState *state);
 
 /**
- * Reset the application state to allow new drawing.
+ * Start the animation from the coefficient cache: the drawing's key is
+ * looked up in state->coef_cache_dir and, on a hit, the stored spectrum
+ * and epicycles are mapped and copied into the state's buffers, with no
+ * transform run. On a miss the key is kept, and the next full transform
+ * (app_start_animation or app_start_animation_async) stores its result,
+ * so the following load of the same input hits. Inputs under
+ * FCOEF_MIN_POINTS are not cached.
+ *
+ * @param state   Application state (drawing already resampled, if at all)
+ * @return        true if the animation started from the cache
+ */
+bool app_start_animation_cached(AppState *state);
+
+/**
+ * Start the animation from the online transform fed while drawing, with
+ * no transform left to run: the spectrum is read out of the accumulators
+ * and the animation covers the grid's L samples (the drawing, then the
+ * closing segment).
+ *
+ * @param state   Application state (state->online in sync with the drawing)
+ * @return        false if the online transform does not match the drawing
+ *                or on allocation failure
+ */
+bool app_start_animation_online(AppState *state);
+
+/**
+ * Start the transform of the current drawing points on a worker thread and
+ * return at once; the frame loop keeps running and calls
+ * app_poll_transform() until the result is published. Any transform still
+ * in flight is cancelled. Buffers come from a spare job, so once warm only
+ * the thread start allocates.
+ *
+ * Inputs of at least 2 * PROGRESSIVE_PREVIEW_POINTS also get a preview:
+ * the drawing is resampled to PROGRESSIVE_PREVIEW_POINTS, transformed on
+ * the calling thread (well under a millisecond) and animated at once
+ * (state->preview). The full spectrum replaces it when published, without
+ * resetting t or the trace.
+ *
+ * @param state   Application state
+ * @return        false if the job could not be started (nothing changed;
+ *                the caller can fall back to app_start_animation())
+ */
+bool app_start_animation_async(AppState *state);
+
+/**
+ * Check on the background transform. A finished job is published here, on
+ * the calling thread: its buffers are swapped into the state in one step
+ * and the animation starts, as after app_start_animation(), or carries on
+ * from the preview's t and trace. This is the frame loop's swap point.
+ *
+ * @return        TRANSFORM_RUNNING while in flight, the job's final status
+ *                on the call that consumes it, TRANSFORM_IDLE otherwise
+ */
+transform_status_t app_poll_transform(AppState *state);
+
+/**
+ * Progress of the background transform (0..1), or -1 when none is in flight.
+ */
+float app_transform_progress(const AppState *state);
+
+/**
+ * Cancel the background transform, if any, without waiting for its thread.
+ * Its result is discarded. Called by app_reset() and by both start functions.
+ */
+void app_cancel_transform(AppState *state);
+
+/**
+ * Change the energy threshold and re-bind the evaluator to the new top-K terms.
+ */
+void app_set_energy_fraction(AppState *state, float fraction);
+
+/**
+ * Advance the animation by the steps the clock grants for this frame.
+ * Each step records the tip into the trace and moves t by 2*pi/N; the
+ * run ends (animation_done) once t reaches 2*pi.
+ *
+ * @param state          Application state (animation started)
+ * @param frame_seconds  Real time since the last frame (scaled by speed here)
+ * @return               Steps run
+ */
+int app_advance_animation(AppState *state, float frame_seconds);
+
+/**
+ * Switch between signed (centered) and unsigned frequencies, rebuilding the
+ * epicycles from the existing spectrum without re-running the transform.
+ * During a preview only the setting is stored; the full spectrum is sorted
+ * for it when app_poll_transform() swaps it in.
+ */
+void app_set_centered_freqs(AppState *state, bool centered);
+
+/**
+ * Reset the application state to allow new drawing. Keeps every buffer for reuse.
  */
 void app_reset(AppState *state);
 
+/**
+ * Free every buffer owned by the state (at shutdown).
+ */
+void app_state_free(AppState *state);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,115 @@
+/**
+ * mem.h - Counted Heap Allocation
+ *
+ * Thin wrappers around malloc/calloc/realloc/free that keep global,
+ * thread-safe allocation counters. The pipeline (fourier, fft, simd, shapes)
+ * allocates only through these so benchmarks and the app can report how
+ * many allocations an operation made.
+ *
+ * Also provides a bump arena for data that lives until a known reset point
+ * (e.g. everything belonging to one drawing session).
+ */
+
+#ifndef MEM_H
+#define MEM_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/* ========== Types ========== */
+
+typedef struct {
+    int allocs;         /* Successful mem_alloc/mem_calloc calls, plus reallocs of NULL */
+    int reallocs;       /* mem_realloc calls that resized an existing block */
+    int frees;          /* mem_free calls with a non-NULL pointer */
+} mem_stats_t;
+
+typedef struct mem_arena_block mem_arena_block_t;
+
+/**
+ * Bump allocator made of chained blocks. Allocations are never freed
+ * individually; mem_arena_reset() drops them all at once and keeps the
+ * memory for the next round.
+ */
+typedef struct {
+    mem_arena_block_t *head;    /* Block currently allocated from */
+    size_t block_size;          /* Minimum size of a new block */
+    void *last;                 /* Most recent allocation (can grow in place) */
+} mem_arena_t;
+
+/* Default minimum block size: 1 MB */
+#define MEM_ARENA_BLOCK_SIZE  (1u << 20)
+
+/* ========== Allocation ========== */
+
+/**
+ * Same contracts as malloc/calloc/realloc/free.
+ */
+void *mem_alloc(size_t size);
+void *mem_calloc(size_t count, size_t size);
+void *mem_realloc(void *ptr, size_t size);
+void  mem_free(void *ptr);
+
+/**
+ * Grow a caller-owned array so it holds at least count elements. Capacity
+ * at least doubles on each growth, so a buffer reused across runs stops
+ * allocating once it has seen the largest size. Contents are preserved.
+ *
+ * @param ptr        Address of the array pointer (array may be NULL)
+ * @param capacity   Address of the element capacity, updated on growth
+ * @param count      Elements needed
+ * @param elem_size  Size of one element
+ * @return           false on allocation failure (array unchanged)
+ */
+bool mem_reserve(void **ptr, int *capacity, int count, size_t elem_size);
+
+/* ========== Arena ========== */
+
+/**
+ * Initialize an empty arena (no allocations until first use).
+ *
+ * @param arena       Arena
+ * @param block_size  Minimum block size in bytes (0 = MEM_ARENA_BLOCK_SIZE)
+ */
+void mem_arena_init(mem_arena_t *arena, size_t block_size);
+
+/**
+ * Allocate size bytes, 16-byte aligned. Valid until the next reset.
+ *
+ * @return      Pointer, or NULL on allocation failure
+ */
+void *mem_arena_alloc(mem_arena_t *arena, size_t size);
+
+/**
+ * Resize an arena allocation. Grows in place when ptr is the most recent
+ * allocation and its block has room, otherwise copies into a new allocation
+ * (the old bytes stay reserved until the next reset).
+ *
+ * @param ptr       Allocation from this arena, or NULL
+ * @param old_size  Current size of ptr
+ * @param new_size  Requested size
+ * @return          Resized allocation, or NULL on failure (ptr stays valid)
+ */
+void *mem_arena_grow(mem_arena_t *arena, void *ptr, size_t old_size, size_t new_size);
+
+/**
+ * Drop every allocation. When the arena spilled into several blocks they
+ * are merged into one block of the combined size, so a session of the same
+ * size fits without further heap allocations.
+ */
+void mem_arena_reset(mem_arena_t *arena);
+
+/**
+ * Free all blocks.
+ */
+void mem_arena_free(mem_arena_t *arena);
+
+/* ========== Counters ========== */
+
+/**
+ * Snapshot of the counters since program start. Subtract two snapshots to
+ * count the allocations made by an operation.
+ */
+mem_stats_t mem_stats(void);
+
+#endif /* MEM_H */
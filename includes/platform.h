@@ -0,0 +1,137 @@
+/**
+ * platform.h - OS Abstraction
+ *
+ * Threads, locks, atomics, timing and directory listing for code that has
+ * to run without a window (batch tools, worker threads). Deliberately does
+ * not include <windows.h>, which clashes with raylib.h.
+ */
+
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ========== Mutex ========== */
+
+#if defined(_WIN32)
+    typedef struct { void *lock; } platform_mutex_t;    /* SRWLOCK */
+    typedef struct { void *cond; } platform_cond_t;     /* CONDITION_VARIABLE */
+    #define PLATFORM_MUTEX_INIT { 0 }
+    #define PLATFORM_COND_INIT  { 0 }
+#else
+    #include <pthread.h>
+    typedef struct { pthread_mutex_t lock; } platform_mutex_t;
+    typedef struct { pthread_cond_t cond; } platform_cond_t;
+    #define PLATFORM_MUTEX_INIT { PTHREAD_MUTEX_INITIALIZER }
+    #define PLATFORM_COND_INIT  { PTHREAD_COND_INITIALIZER }
+#endif
+
+/**
+ * Lock/unlock a mutex. Mutexes are statically initialized with PLATFORM_MUTEX_INIT.
+ */
+void platform_mutex_lock(platform_mutex_t *m);
+void platform_mutex_unlock(platform_mutex_t *m);
+
+/**
+ * Condition variables, statically initialized with PLATFORM_COND_INIT.
+ * Wait atomically releases the (locked) mutex and re-locks it before
+ * returning; wakeups may be spurious, so always wait in a loop.
+ */
+void platform_cond_wait(platform_cond_t *c, platform_mutex_t *m);
+void platform_cond_broadcast(platform_cond_t *c);
+
+/* ========== Threads ========== */
+
+typedef struct platform_thread platform_thread_t;
+typedef void (*platform_thread_fn)(void *arg);
+
+/**
+ * Start a thread running fn(arg).
+ *
+ * @return      Thread handle, or NULL on failure
+ */
+platform_thread_t *platform_thread_start(platform_thread_fn fn, void *arg);
+
+/**
+ * Wait for a thread to finish and free its handle.
+ */
+void platform_thread_join(platform_thread_t *thread);
+
+/**
+ * Number of logical processors (at least 1).
+ */
+int platform_cpu_count(void);
+
+/* ========== Atomics ========== */
+
+/**
+ * Atomically add to an int and return the new value.
+ */
+int platform_atomic_add(volatile int *value, int delta);
+
+/**
+ * Atomic load/store with full barriers.
+ */
+int  platform_atomic_load(volatile int *value);
+void platform_atomic_store(volatile int *value, int new_value);
+
+/* ========== Time ========== */
+
+/**
+ * Monotonic time in seconds (arbitrary origin, sub-microsecond resolution).
+ */
+double platform_time_seconds(void);
+
+/* ========== Files ========== */
+
+typedef void (*platform_dir_fn)(const char *path, void *user);
+
+/**
+ * Check whether a path names a directory.
+ */
+bool platform_is_dir(const char *path);
+
+/**
+ * Create a directory (not its parents).
+ *
+ * @return      true if the directory exists afterwards
+ */
+bool platform_make_dir(const char *path);
+
+/**
+ * Move a file over another in one step, so readers of `to` see either the
+ * old file or the complete new one.
+ */
+bool platform_replace_file(const char *from, const char *to);
+
+/**
+ * Call fn(path, user) for every regular file in a directory (not recursive).
+ * Paths are "dir/name".
+ *
+ * @return      Number of files visited, or -1 if the directory cannot be opened
+ */
+int platform_list_dir(const char *dir, platform_dir_fn fn, void *user);
+
+/**
+ * Read-only view of a whole file. Pages are read in by the OS as they are
+ * touched, so even very large files cost no copy and no heap memory.
+ */
+typedef struct {
+    const char *data;   /* File contents, not NUL-terminated */
+    size_t size;
+} platform_file_map_t;
+
+/**
+ * Map a file for reading. An empty file maps to size 0 (data is valid).
+ *
+ * @return      false if the file cannot be opened or mapped
+ */
+bool platform_map_file(const char *path, platform_file_map_t *map);
+
+/**
+ * Release a mapping made by platform_map_file() and clear it.
+ */
+void platform_unmap_file(platform_file_map_t *map);
+
+#endif /* PLATFORM_H */
@@ -0,0 +1,73 @@
+/**
+ * points.h - Growable Point Lists
+ *
+ * Dynamically sized Vector2 arrays used for drawn/loaded shapes and the
+ * animation trace. A list either grows inside a mem_arena_t (app session
+ * data, released all at once by mem_arena_reset) or on the heap when no
+ * arena is given (batch tools).
+ */
+
+#ifndef POINTS_H
+#define POINTS_H
+
+#include "raylib.h"
+#include "mem.h"
+
+/* ========== Types ========== */
+
+typedef struct {
+    Vector2 *data;
+    int count;
+    int capacity;
+    mem_arena_t *arena;     /* NULL = heap-backed */
+} point_list_t;
+
+/* ========== Functions ========== */
+
+/**
+ * Initialize an empty list (no allocations).
+ *
+ * @param list    List
+ * @param arena   Arena to grow in, or NULL for the heap
+ */
+void point_list_init(point_list_t *list, mem_arena_t *arena);
+
+/**
+ * Make room for at least capacity points (grows geometrically).
+ *
+ * @return        false on allocation failure (contents unchanged)
+ */
+bool point_list_reserve(point_list_t *list, int capacity);
+
+/**
+ * Append a point.
+ *
+ * @return        false on allocation failure
+ */
+bool point_list_push(point_list_t *list, Vector2 p);
+
+/**
+ * Remove all points, keeping the storage.
+ */
+void point_list_clear(point_list_t *list);
+
+/**
+ * Release the storage of a heap-backed list (arena lists are released by
+ * resetting their arena) and leave it empty.
+ */
+void point_list_free(point_list_t *list);
+
+/**
+ * Resample a closed polyline to m points spaced evenly by arc length,
+ * starting at its first point. The closing edge (last point back to the
+ * first) counts as part of the path. Repeated points add no length, so
+ * a dense or stalled stretch gets no more samples than any other.
+ *
+ * @param src     Input polyline (count > 0)
+ * @param dst     Output list, replaced with m points (must not be src)
+ * @param m       Sample count (>= 1)
+ * @return        false on allocation failure
+ */
+bool point_list_resample(const point_list_t *src, point_list_t *dst, int m);
+
+#endif /* POINTS_H */
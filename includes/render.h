@@ -0,0 +1,108 @@
+/**
+ * render.h - Epicycle Rendering
+ * 
+ * Drawing code for the animation. Kept out of fourier.c so the transform
+ * pipeline can be linked without raylib's window/GL layer.
+ */
+
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "fourier.h"
+
+/* ========== Types ========== */
+
+typedef struct {
+    int vertices;       /* Vertices submitted by the last draw_epicycles() */
+    int triangles;
+    int circles;        /* Epicycles drawn (amplitude above 1 px) */
+    int batches;        /* rlBegin/rlEnd runs; each is one draw call unless merged with the previous draw */
+    int trace_segments; /* Segments rendered into the trace layer by the last trace_layer_update() */
+    bool trace_redraw;  /* That update had to redraw the whole trace */
+    int layer_redraws;  /* Full layer rasterizations since startup */
+} render_stats_t;
+
+/* Cached layers, combinable as a bit mask for render_invalidate() */
+enum {
+    RENDER_LAYER_INPUT = 1 << 0,    /* User's input path */
+    RENDER_LAYER_TRACE = 1 << 1,    /* Recorded trace */
+    RENDER_LAYER_PANEL = 1 << 2,    /* Panel background, border, title and separator */
+    RENDER_LAYER_ALL   = RENDER_LAYER_INPUT | RENDER_LAYER_TRACE | RENDER_LAYER_PANEL
+};
+
+/* ========== Functions ========== */
+
+/**
+ * Draw the epicycle circles and arms at the evaluator's current step.
+ * All geometry goes into one vertex buffer and is submitted as a single
+ * batch (split only past raylib's per-batch vertex limit).
+ * 
+ * @param ev              Evaluator positioned at the current step
+ * @param line_thickness  Arm thickness (the tip dot scales with it)
+ * @param alpha           Fraction of the way to the next step (0..1); each
+ *                        arm is blended with its next-step vector
+ * @return                Tip position
+ */
+Vector2 draw_epicycles(const epicycle_eval_t *ev, float line_thickness, float alpha);
+
+/**
+ * Render the input path into its layer. Points appended since the last
+ * call are drawn incrementally (live mouse drawing); a shorter path or an
+ * invalidated layer is redrawn from scratch.
+ *
+ * @param points    Input path
+ */
+void input_layer_update(const point_list_t *points);
+
+/**
+ * Draw the input layer over the whole window.
+ */
+void input_layer_draw(void);
+
+/**
+ * Render the trace segments added since the last call into the offscreen
+ * trace layer. Segment i is shaded by i / total_steps, so colors never
+ * change once drawn; a different base color or thickness, or a trace that
+ * got shorter (restart), redraws the layer from scratch.
+ *
+ * @param trace         Trace points so far
+ * @param total_steps   Points in a full cycle (the gradient reaches full color there)
+ * @param base          Trace color
+ * @param thickness     Line thickness
+ */
+void trace_layer_update(const point_list_t *trace, int total_steps, Color base, float thickness);
+
+/**
+ * Draw the trace layer over the whole window.
+ */
+void trace_layer_draw(void);
+
+/**
+ * Draw the panel chrome (background, border, title and first separator)
+ * from its cached layer. The layer is rebuilt when the panel height
+ * changes or after render_invalidate(RENDER_LAYER_PANEL).
+ *
+ * @param rect      Panel rectangle in window coordinates
+ * @param title     Panel title (read only when the layer is rebuilt)
+ */
+void panel_layer_draw(Rectangle rect, const char *title);
+
+/**
+ * Mark layers stale so their next update redraws them from scratch.
+ * Call on load, reset or a color change.
+ *
+ * @param layers    RENDER_LAYER_* bit mask
+ */
+void render_invalidate(int layers);
+
+/**
+ * Counters of the last draw_epicycles() and trace_layer_update() calls.
+ */
+render_stats_t render_last_stats(void);
+
+/**
+ * Free the renderer's vertex buffer and layers (at shutdown).
+ */
+void render_shutdown(void);
+
+#endif /* RENDER_H */
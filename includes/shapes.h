@@ -9,6 +9,13 @@
 #define SHAPES_H
 
 #include "raylib.h"
+#include "points.h"
+
+/* Default largest gap between an SVG curve and its flattened chords, in pixels of the loaded shape */
+#define SVG_FLATTEN_TOLERANCE     0.25f
+
+/* Most chords a single curve is split into */
+#define SVG_FLATTEN_MAX_SEGMENTS  1024
 
 /* Shape generation functions - return number of points generated */
 int generate_circle(Vector2 *points, float cx, float cy, float radius, int num_points);
@@ -18,10 +25,90 @@ int generate_heart(Vector2 *points, float cx, float cy, float size, int num_poin
 int generate_infinity(Vector2 *points, float cx, float cy, float size, int num_points);
 int generate_spiral(Vector2 *points, float cx, float cy, float max_radius, int num_points);
 
-/* Load shape from a text file (one "x y" coordinate per line) */
-int load_shape_from_file(Vector2 *points, const char *filename, float cx, float cy, float scale, int max_points);
+/* Locale-independent float scanner used by both loaders. Reads one number at p (optional sign,
+ * digits, one '.', exponent) and stops where it cannot continue, so SVG's compact forms split
+ * correctly: "1.5.5" is 1.5 then .5, "-1-2" is -1 then -2, "1e-3" is 0.001. Never reads past end.
+ * Returns the end of the number, or p if there is none (out = 0). */
+const char *scan_float(const char *p, const char *end, float *out);
+
+/* Load shape from a text file (one "x y" coordinate per line) - appends to points, returns number added */
+int load_shape_from_file(point_list_t *points, const char *filename, float cx, float cy, float scale);
+
+/* Load shape from an SVG file (every drawn path, in document order, subpaths and paths concatenated
+ * into one tour) - appends to points, returns number added. The file is memory-mapped, not copied. */
+int load_svg_file(point_list_t *points, const char *filename, float cx, float cy, float scale);
+
+/* 2D affine transform in SVG's matrix(a b c d e f) order: x' = a*x + c*y + e, y' = b*x + d*y + f */
+typedef struct {
+    float a, b, c, d, e, f;
+} svg_matrix_t;
+
+/* Deepest element nesting whose transforms are tracked; deeper elements use the matrix at this depth */
+#define SVG_MAX_DEPTH  64
+
+/* Streaming scan of SVG markup for path elements. Works on a buffer that need not be
+ * NUL-terminated (e.g. a mapped file) and never writes to it. Paths inside <defs>,
+ * <clipPath>, <mask>, <symbol>, <marker> and <pattern> are skipped, as are comments,
+ * CDATA sections and <script>/<style> contents. transform attributes (matrix, translate,
+ * scale, rotate, skewX, skewY) and the viewBox/width/height/preserveAspectRatio of <svg>
+ * elements are composed into one matrix per path. */
+typedef struct {
+    const char *data;
+    size_t size;
+    size_t pos;         /* Scan position */
+    int hidden_depth;   /* Open non-rendered containers */
+    int depth;          /* Open elements */
+    svg_matrix_t ctm[SVG_MAX_DEPTH];    /* User space to document space inside each open element */
+    svg_matrix_t matrix;                /* Same, for the path svg_next_path() last returned */
+} svg_reader_t;
+
+void svg_reader_init(svg_reader_t *reader, const char *svg, size_t size);
+
+/* d attribute of the next <path> element: a pointer into the buffer (not terminated) and its
+ * length, or NULL when there are no more paths. reader->matrix then maps the path's
+ * coordinates to document space. */
+const char *svg_next_path(svg_reader_t *reader, int *length);
+
+/* Why a path stopped early. Following SVG, a path with an error keeps the segments before the
+ * command in error and ignores the rest of its data. */
+typedef enum {
+    SVG_PATH_OK = 0,
+    SVG_PATH_BAD_COMMAND,   /* Not a path command letter, or arguments after Z/z */
+    SVG_PATH_NO_MOVETO,     /* Path data does not start with M/m */
+    SVG_PATH_BAD_NUMBER,    /* Missing or malformed argument */
+    SVG_PATH_BAD_FLAG       /* Arc flag other than 0 or 1 */
+} svg_path_error_t;
+
+typedef struct {
+    svg_path_error_t error; /* First error, SVG_PATH_OK if all data was read */
+    int offset;             /* Byte offset of the first error in the path data (documents: in the document) */
+    int path;               /* Documents: index of the path element with the first error */
+    int commands;           /* Commands read, implicit repeats included */
+} svg_path_status_t;
+
+/* Short description of an error, e.g. "missing or malformed number" */
+const char *svg_path_error_string(svg_path_error_t error);
+
+/* Flatten SVG path data d[0..length) (no centering/scaling) - appends to out, returns number of
+ * points added. Supports the full path grammar (M L H V C S Q T A Z, absolute and relative,
+ * implicit command repetition); arcs become cubic curves. Curves get as many chords as keep them
+ * within `tolerance` of the true curve, given as a fraction of the path's size (larger side of its
+ * bounding box). status (may be NULL) receives the command count and the first error. */
+int parse_svg_path(const char *d, int length, point_list_t *out, float tolerance, svg_path_status_t *status);
+
+/* Flatten every drawn path of an SVG document svg[0..size) into one tour in document space
+ * (transforms and viewBox applied, no centering/scaling),
+ * with the tolerance taken against the whole drawing - appends to out, returns number of points
+ * added and, if paths is not NULL, how many path elements were found. A path with an error
+ * contributes its data up to the error; status (may be NULL) receives the first one. */
+int parse_svg_document(const char *svg, size_t size, point_list_t *out, float tolerance, int *paths,
+                       svg_path_status_t *status);
+
+/* Set the SVG flattening tolerance in pixels of the loaded shape (default: SVG_FLATTEN_TOLERANCE) */
+void shapes_set_flatten_tolerance(float pixels);
+float shapes_flatten_tolerance(void);
 
-/* Load shape from an SVG file (extracts first path element) */
-int load_svg_file(Vector2 *points, const char *filename, float cx, float cy, float scale, int max_points);
+/* Enable/disable the "Loaded N points" messages on stderr (default: enabled) */
+void shapes_set_verbose(bool verbose);
 
 #endif
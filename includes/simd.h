@@ -0,0 +1,112 @@
+/**
+ * simd.h - Vectorized Epicycle Summation
+ *
+ * A structure-of-arrays copy of the epicycles plus kernels that evaluate
+ * sum_k amplitude[k] * e^(i*(frequency[k]*t + phase[k])) several terms at
+ * a time. The path (scalar, SSE2, AVX2, AVX-512, NEON) is picked once by
+ * CPUID at startup.
+ *
+ * sin/cos come from a shared polynomial instead of libm:
+ *   - the angle is handled in turns, u = frequency * t/(2*pi) + phase/(2*pi),
+ *     and reduced exactly to r in [-1/8, 1/8] turn plus a quadrant
+ *   - sin(r) and cos(r) use minimax polynomials of degree 7 and 8
+ *   - max absolute error vs. sin/cos of the same float argument is
+ *     9.1e-8 (see simd.c), below one float ulp of 1.0
+ *
+ * Every path computes the same per-term values with the same operations
+ * and accumulates term k into partial sum k % 16, so all paths return
+ * bit-identical results.
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include "fourier.h"
+
+/* Terms per partial-sum group; SoA arrays are padded to a multiple of this */
+#define SIMD_LANES  16
+
+/* ========== Types ========== */
+
+typedef enum {
+    SIMD_PATH_SCALAR,
+    SIMD_PATH_SSE2,     /* 4 terms per instruction */
+    SIMD_PATH_AVX2,     /* 8 terms per instruction */
+    SIMD_PATH_AVX512,   /* 16 terms per instruction */
+    SIMD_PATH_NEON,     /* 4 terms per instruction */
+    SIMD_PATH_COUNT
+} simd_path_t;
+
+/* epicycle_soa_t is declared in fourier.h so AppState can embed one */
+
+/* ========== Dispatch ========== */
+
+/**
+ * Detect CPU features and select the widest supported path.
+ * Called automatically on first use; safe to call again.
+ *
+ * @return      Selected path
+ */
+simd_path_t simd_init(void);
+
+/**
+ * Get the currently selected path.
+ */
+simd_path_t simd_active_path(void);
+
+/**
+ * Check whether this build and CPU can run a path.
+ */
+bool simd_path_supported(simd_path_t path);
+
+/**
+ * Force a path (benchmarks, comparisons). Unsupported paths are ignored.
+ *
+ * @return      true if the path is now active
+ */
+bool simd_set_path(simd_path_t path);
+
+/**
+ * Human-readable path name ("scalar", "sse2", ...).
+ */
+const char *simd_path_name(simd_path_t path);
+
+/* ========== SoA Store ========== */
+
+/**
+ * Initialize an empty store (no allocations).
+ */
+void epicycle_soa_init(epicycle_soa_t *soa);
+
+/**
+ * Copy epicycles into the store, growing its buffers when needed.
+ *
+ * @param soa     Store
+ * @param epic    Epicycles (array of structs)
+ * @param N       Number of epicycles
+ * @return        false on allocation failure
+ */
+bool epicycle_soa_load(epicycle_soa_t *soa, const epicycle_t *epic, int N);
+
+/**
+ * Free the store's buffers.
+ */
+void epicycle_soa_free(epicycle_soa_t *soa);
+
+/**
+ * Sum of all epicycles at time t using the active path.
+ * Same result as epicycles_position(), up to the polynomial error above.
+ */
+Vector2 epicycle_soa_position(const epicycle_soa_t *soa, float t);
+
+/**
+ * Same as epicycle_soa_position() but on an explicit path (must be supported).
+ */
+Vector2 epicycle_soa_position_path(const epicycle_soa_t *soa, float t, simd_path_t path);
+
+/**
+ * Scalar reference of the shared polynomial: sin and cos of 2*pi*u.
+ */
+void simd_sincos_turns(float u, float *s, float *c);
+
+#endif /* SIMD_H */
@@ -0,0 +1,68 @@
+/**
+ * task_pool.h - Work-Stealing Task Pool
+ *
+ * A process-wide pool of worker threads for data-parallel loops. A call to
+ * task_pool_run() splits an index range into chunks and deals them out to
+ * one queue per thread; a thread that drains its own queue steals chunks
+ * from the others, so uneven chunks still finish together. The calling
+ * thread works as one of the threads and returns once every chunk is done.
+ *
+ * Only one loop runs on the pool at a time. A task_pool_run() issued while
+ * the pool is busy (another thread's loop, or a nested call from inside a
+ * task) runs serially on the caller instead of waiting.
+ *
+ * Which thread runs a chunk is not deterministic, so tasks must write
+ * disjoint outputs and must not depend on execution order; the results
+ * are then identical to a serial run.
+ */
+
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <stdbool.h>
+
+/* Most threads (caller included) a pool will use */
+#define TASK_POOL_MAX_THREADS  64
+
+/* ========== Types ========== */
+
+/**
+ * Process indices [begin, end) of a loop.
+ */
+typedef void (*task_pool_fn)(void *ctx, int begin, int end);
+
+/* ========== Functions ========== */
+
+/**
+ * Set how many threads (caller included) loops use. Takes effect on the
+ * next task_pool_run(); the workers are restarted if the count changes.
+ *
+ * @param threads   Thread count; 0 = one per logical processor, 1 = serial
+ */
+void task_pool_set_threads(int threads);
+
+/**
+ * Thread count the next loop will use (resolved, at least 1).
+ */
+int task_pool_threads(void);
+
+/**
+ * Run fn over [0, count) in chunks of `grain` indices. Starts the worker
+ * threads on first use. Falls back to a serial run when the pool has one
+ * thread, is busy, or the range is a single chunk.
+ *
+ * @param count     Number of indices
+ * @param grain     Indices per chunk (>= 1)
+ * @param fn        Chunk function
+ * @param ctx       Passed to fn
+ * @return          true if the loop ran on several threads
+ */
+bool task_pool_run(int count, int grain, task_pool_fn fn, void *ctx);
+
+/**
+ * Stop and join the worker threads (at shutdown, with no loop running).
+ * The pool restarts on the next task_pool_run().
+ */
+void task_pool_shutdown(void);
+
+#endif /* TASK_POOL_H */
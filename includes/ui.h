@@ -57,6 +57,16 @@ bool draw_button(int x, int y, int w, int h, const char *text, Color bg, Color h
  */
 float draw_slider(int x, int y, int w, float value, float min_val, float max_val, const char *label);
 
+/**
+ * Draw a horizontal slider with a custom value format.
+ * 
+ * @param fmt       printf-style format for the value (e.g. "%.1f%%")
+ * @return          New value (may be unchanged or dragged)
+ * @see draw_slider
+ */
+float draw_slider_ex(int x, int y, int w, float value, float min_val, float max_val,
+                     const char *label, const char *fmt);
+
 /**
  * Draw a horizontal separator line within the panel.
  * 
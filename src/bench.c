@@ -0,0 +1,910 @@
+/**
+ * bench.c - Microbenchmark Suite
+ *
+ * Times the hot parts of the pipeline and reports, per benchmark:
+ *   - ns/op (median of several samples, plus the fastest sample)
+ *   - throughput in items/s (points, terms or bytes, see "unit")
+ *   - heap allocations per op, counted through mem.h
+ *
+ * Results go to stdout (or --out) as JSON or CSV so runs from different
+ * commits can be diffed; a readable table goes to stderr.
+ *
+ * Usage:
+ *   fourier_bench [options]
+ *
+ * Options:
+ *   --format json|csv   Output format (default: json)
+ *   --out PATH          Output file (default: stdout)
+ *   --filter TEXT       Only run benchmarks whose name contains TEXT
+ *   --shapes DIR        Shape directory (default: shapes)
+ *   --min-time SEC      Minimum duration of one sample (default: 0.02)
+ *   --samples N         Samples per benchmark (default: 5)
+ *   --label TEXT        Free-form run label stored in the output (e.g. a commit id)
+ *   --threads N         Task pool threads for large transforms (default: all cores)
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+#include "fourier.h"
+#include "fcoef.h"
+#include "shapes.h"
+#include "simd.h"
+#include "mem.h"
+#include "platform.h"
+#include "fft.h"
+#include "task_pool.h"
+#include <string.h>
+
+#define BENCH_MAX_RESULTS   256
+#define BENCH_MAX_SAMPLES   32
+#define BENCH_MAX_FILES     64
+
+/* ========== Types ========== */
+
+typedef void (*bench_fn)(void *ctx);
+
+typedef struct {
+    char name[96];
+    const char *unit;           /* What one item is: "points", "terms", "bytes" */
+    double items_per_op;
+    long long iterations;       /* Per sample */
+    double ns_per_op;           /* Median sample */
+    double ns_min;              /* Fastest sample */
+    double items_per_sec;       /* From the median */
+    double allocs_per_op;
+} bench_result_t;
+
+typedef struct {
+    const char *filter;
+    double min_time;
+    int samples;
+    bench_result_t results[BENCH_MAX_RESULTS];
+    int result_count;
+} bench_t;
+
+typedef struct {
+    complex_t *input;
+    int n;
+} dft_ctx_t;
+
+typedef struct {
+    const fft_plan_t *plan;
+    const complex_t *input;
+    complex_t *output;
+} fft_ctx_t;
+
+typedef struct {
+    online_dft_t od;
+    point_list_t points;
+    complex_t *output;
+} online_ctx_t;
+
+typedef struct {
+    epicycle_t *epic;
+    epicycle_soa_t soa;
+    epicycle_eval_t eval;
+    int terms;
+    int step;
+    float t;
+    float dt;
+} epicycle_ctx_t;
+
+typedef struct {
+    const char *d;
+    int length;
+    point_list_t *points;
+} parse_ctx_t;
+
+typedef struct {
+    const char *svg;
+    size_t size;
+    point_list_t *points;
+} svg_doc_ctx_t;
+
+typedef struct {
+    const char *text;   /* NUL-terminated, for strtof/sscanf */
+    size_t size;
+} number_ctx_t;
+
+typedef struct {
+    const char *path;
+    point_list_t *points;
+    bool svg;
+} load_ctx_t;
+
+typedef struct {
+    const point_list_t *points;
+    point_list_t *output;
+    int m;
+} resample_ctx_t;
+
+typedef struct {
+    AppState *state;
+    const char *path;
+} app_ctx_t;
+
+typedef struct {
+    char *paths[BENCH_MAX_FILES];
+    int count;
+} file_list_t;
+
+/* Results are written here so the compiler cannot drop the benchmarked work */
+static volatile float bench_sink;
+
+/* ========== Harness ========== */
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double time_iterations(bench_fn fn, void *ctx, long long iterations)
+{
+    double start = platform_time_seconds();
+    for (long long i = 0; i < iterations; i++) fn(ctx);
+    return platform_time_seconds() - start;
+}
+
+static void bench_run(bench_t *bench, const char *name, bench_fn fn, void *ctx,
+                      double items_per_op, const char *unit)
+{
+    if (bench->filter && !strstr(name, bench->filter)) return;
+    if (bench->result_count == BENCH_MAX_RESULTS) return;
+
+    /* Warm up (plan caches, page faults), then grow the batch until one sample takes min_time */
+    fn(ctx);
+    long long iterations = 1;
+    while (time_iterations(fn, ctx, iterations) < bench->min_time && iterations < (1LL << 40)) {
+        iterations *= 2;
+    }
+
+    double samples[BENCH_MAX_SAMPLES];
+    mem_stats_t before = mem_stats();
+    for (int s = 0; s < bench->samples; s++) {
+        samples[s] = time_iterations(fn, ctx, iterations) * 1e9 / (double)iterations;
+    }
+    mem_stats_t after = mem_stats();
+    qsort(samples, (size_t)bench->samples, sizeof(double), compare_doubles);
+
+    bench_result_t *r = &bench->results[bench->result_count++];
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    r->unit = unit;
+    r->items_per_op = items_per_op;
+    r->iterations = iterations;
+    r->ns_per_op = samples[bench->samples / 2];
+    r->ns_min = samples[0];
+    r->items_per_sec = items_per_op * 1e9 / r->ns_per_op;
+    r->allocs_per_op = (double)((after.allocs - before.allocs) + (after.reallocs - before.reallocs)) /
+                       ((double)iterations * bench->samples);
+
+    fprintf(stderr, "%-40s %14.1f ns/op %12.3g %s/s %8.2f allocs/op\n",
+            r->name, r->ns_per_op, r->items_per_sec, unit, r->allocs_per_op);
+}
+
+/* ========== Inputs ========== */
+
+/* Deterministic test signal: a closed wobbly curve (no libc rand) */
+static void make_signal(complex_t *out, int n)
+{
+    unsigned int seed = 12345u;
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        float noise = (float)(seed >> 8) / 16777216.0f - 0.5f;
+        float angle = 2 * PI * i / n;
+        float r = 200.0f + 40.0f * sinf(5 * angle) + 10.0f * noise;
+        out[i].real = r * cosf(angle);
+        out[i].imag = r * sinf(angle);
+    }
+}
+
+static void collect_file(const char *path, void *user)
+{
+    file_list_t *list = (file_list_t *)user;
+    if (list->count == BENCH_MAX_FILES) return;
+
+    size_t len = strlen(path);
+    char *copy = (char *)malloc(len + 1);
+    if (!copy) return;
+    memcpy(copy, path, len + 1);
+    list->paths[list->count++] = copy;
+}
+
+static int compare_paths(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static bool has_extension(const char *path, const char *ext)
+{
+    size_t len = strlen(path), ext_len = strlen(ext);
+    return len > ext_len && strcmp(path + len - ext_len, ext) == 0;
+}
+
+static const char *base_name(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+    const char *backslash = strrchr(path, '\\');
+    if (backslash > slash) slash = backslash;
+    return slash ? slash + 1 : path;
+}
+
+static char *read_text_file(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *text = (char *)malloc((size_t)size + 1);
+    if (text) {
+        size_t got = fread(text, 1, (size_t)size, file);
+        text[got] = '\0';
+    }
+    fclose(file);
+    return text;
+}
+
+/* ========== Benchmarks ========== */
+
+static void op_dft(void *ctx)
+{
+    dft_ctx_t *c = (dft_ctx_t *)ctx;
+    complex_t *out = DFT(c->input, c->n);
+    bench_sink = out[c->n - 1].real;
+    mem_free(out);
+}
+
+static void op_fft_execute(void *ctx)
+{
+    fft_ctx_t *c = (fft_ctx_t *)ctx;
+    fft_execute(c->plan, c->input, c->output);
+    bench_sink = c->output[0].real;
+}
+
+/* Cost of one freehand point: grow the input by one, update, then drop it again */
+static void op_online_dft_point(void *ctx)
+{
+    online_ctx_t *c = (online_ctx_t *)ctx;
+    c->points.count++;
+    online_dft_update(&c->od, &c->points);
+    c->points.count--;
+    c->od.count--;
+    bench_sink = (float)c->od.acc[1].real;
+}
+
+/* What mouse release still has to do: read the spectrum out */
+static void op_online_dft_spectrum(void *ctx)
+{
+    online_ctx_t *c = (online_ctx_t *)ctx;
+    online_dft_spectrum(&c->od, &c->points, c->output);
+    bench_sink = c->output[1].real;
+}
+
+static void op_epicycles_position(void *ctx)
+{
+    epicycle_ctx_t *c = (epicycle_ctx_t *)ctx;
+    Vector2 p = epicycles_position(c->epic, c->terms, c->t);
+    c->t += c->dt;
+    if (c->t >= 2 * PI) c->t -= 2 * PI;
+    bench_sink = p.x + p.y;
+}
+
+static void op_soa_position(void *ctx)
+{
+    epicycle_ctx_t *c = (epicycle_ctx_t *)ctx;
+    Vector2 p = epicycle_soa_position(&c->soa, c->t);
+    c->t += c->dt;
+    if (c->t >= 2 * PI) c->t -= 2 * PI;
+    bench_sink = p.x + p.y;
+}
+
+static void op_eval_step(void *ctx)
+{
+    epicycle_ctx_t *c = (epicycle_ctx_t *)ctx;
+    epicycle_eval_step(&c->eval);
+    Vector2 p = epicycle_eval_position(&c->eval);
+    bench_sink = p.x + p.y;
+}
+
+static void op_parse_svg_path(void *ctx)
+{
+    parse_ctx_t *c = (parse_ctx_t *)ctx;
+    point_list_clear(c->points);
+    bench_sink = (float)parse_svg_path(c->d, c->length, c->points, SVG_FLATTEN_TOLERANCE / DEFAULT_LOAD_SCALE, NULL);
+}
+
+/* Every number in SVG path data, the way the parser used to read them: strtof */
+static void op_numbers_strtof(void *ctx)
+{
+    number_ctx_t *c = (number_ctx_t *)ctx;
+    const char *p = c->text;
+    float sum = 0.0f;
+    while (*p) {
+        char *stop;
+        float v = strtof(p, &stop);
+        if (stop == p) { p++; continue; }
+        sum += v;
+        p = stop;
+    }
+    bench_sink = sum;
+}
+
+static void op_numbers_scan_float(void *ctx)
+{
+    number_ctx_t *c = (number_ctx_t *)ctx;
+    const char *p = c->text;
+    const char *end = c->text + c->size;
+    float sum = 0.0f;
+    while (p < end) {
+        float v;
+        const char *stop = scan_float(p, end, &v);
+        if (stop == p) { p++; continue; }
+        sum += v;
+        p = stop;
+    }
+    bench_sink = sum;
+}
+
+/* "x y" lines, the way the TXT loader used to read them: a line at a time, then sscanf */
+static void op_lines_sscanf(void *ctx)
+{
+    number_ctx_t *c = (number_ctx_t *)ctx;
+    const char *p = c->text;
+    char line[256];
+    float sum = 0.0f;
+    while (*p) {
+        const char *nl = strchr(p, '\n');
+        size_t len = nl ? (size_t)(nl - p) : strlen(p);
+        if (len >= sizeof(line)) len = sizeof(line) - 1;
+        memcpy(line, p, len);
+        line[len] = '\0';
+        float x, y;
+        if (sscanf(line, "%f %f", &x, &y) == 2) sum += x + y;
+        p = nl ? nl + 1 : p + len;
+    }
+    bench_sink = sum;
+}
+
+static void op_lines_scan_float(void *ctx)
+{
+    number_ctx_t *c = (number_ctx_t *)ctx;
+    const char *p = c->text;
+    const char *end = c->text + c->size;
+    float sum = 0.0f;
+    while (p < end) {
+        float x, y;
+        const char *q = scan_float(p, end, &x);
+        while (q < end && *q == ' ') q++;
+        const char *r = scan_float(q, end, &y);
+        if (r > q) sum += x + y;
+        const char *nl = (const char *)memchr(r, '\n', (size_t)(end - r));
+        p = nl ? nl + 1 : end;
+    }
+    bench_sink = sum;
+}
+
+static void op_svg_document(void *ctx)
+{
+    svg_doc_ctx_t *c = (svg_doc_ctx_t *)ctx;
+    point_list_clear(c->points);
+    bench_sink = (float)parse_svg_document(c->svg, c->size, c->points, SVG_FLATTEN_TOLERANCE / DEFAULT_LOAD_SCALE, NULL, NULL);
+}
+
+static void op_load_file(void *ctx)
+{
+    load_ctx_t *c = (load_ctx_t *)ctx;
+    point_list_clear(c->points);
+    int n = c->svg ? load_svg_file(c->points, c->path, 0.0f, 0.0f, DEFAULT_LOAD_SCALE)
+                   : load_shape_from_file(c->points, c->path, 0.0f, 0.0f, DEFAULT_LOAD_SCALE);
+    bench_sink = (float)n;
+}
+
+static void op_resample(void *ctx)
+{
+    resample_ctx_t *c = (resample_ctx_t *)ctx;
+    point_list_resample(c->points, c->output, c->m);
+    bench_sink = c->output->data[c->m / 2].x;
+}
+
+static void op_app_start(void *ctx)
+{
+    app_ctx_t *c = (app_ctx_t *)ctx;
+    app_start_animation(c->state);
+    bench_sink = (float)c->state->active_terms;
+}
+
+static void op_app_start_cached(void *ctx)
+{
+    app_ctx_t *c = (app_ctx_t *)ctx;
+    bench_sink = app_start_animation_cached(c->state) ? (float)c->state->active_terms : -1.0f;
+}
+
+static void op_app_reload(void *ctx)
+{
+    app_ctx_t *c = (app_ctx_t *)ctx;
+    app_reset(c->state);
+    load_svg_file(&c->state->drawing_points, c->path, 700.0f, 500.0f, DEFAULT_LOAD_SCALE);
+    app_start_animation(c->state);
+    bench_sink = (float)c->state->active_terms;
+}
+
+static void bench_dft(bench_t *bench)
+{
+    static const int sizes[] = {
+        /* Powers of two */
+        64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768, 65536,
+        /* Primes (Bluestein) */
+        61, 127, 251, 509, 1021, 2039, 4093, 8191, 16381, 32749, 65521,
+        /* Mixed radix */
+        96, 1000, 2556, 10000, 48000
+    };
+    int count = (int)(sizeof(sizes) / sizeof(sizes[0]));
+    char name[96];
+
+    complex_t *input = (complex_t *)malloc(sizeof(complex_t) * 65536);
+    if (!input) return;
+
+    for (int i = 0; i < count; i++) {
+        dft_ctx_t ctx = { input, sizes[i] };
+        make_signal(input, sizes[i]);
+        snprintf(name, sizeof(name), "dft/%d", sizes[i]);
+        bench_run(bench, name, op_dft, &ctx, sizes[i], "points");
+    }
+    free(input);
+}
+
+/* Large transforms on one thread vs the task pool; both runs must agree bit for bit */
+static void bench_fft_threads(bench_t *bench)
+{
+    static const int sizes[] = { 65536, 262144, 1048576, 48000, 65521 };
+    int count = (int)(sizeof(sizes) / sizeof(sizes[0]));
+    int pool_threads = task_pool_threads();
+    char name[96];
+
+    for (int i = 0; i < count; i++) {
+        int n = sizes[i];
+        fft_plan_t *plan = fft_plan_create(n);
+        complex_t *input = (complex_t *)malloc(sizeof(complex_t) * n);
+        complex_t *serial = (complex_t *)malloc(sizeof(complex_t) * n);
+        complex_t *parallel = (complex_t *)malloc(sizeof(complex_t) * n);
+        if (plan && input && serial && parallel) {
+            make_signal(input, n);
+
+            fft_set_parallel_threshold(0);
+            fft_ctx_t ctx = { plan, input, serial };
+            snprintf(name, sizeof(name), "fft_threads/1/%d", n);
+            bench_run(bench, name, op_fft_execute, &ctx, n, "points");
+
+            fft_set_parallel_threshold(1);
+            ctx.output = parallel;
+            snprintf(name, sizeof(name), "fft_threads/%d/%d", pool_threads, n);
+            bench_run(bench, name, op_fft_execute, &ctx, n, "points");
+
+            /* Fresh run of each path (the timed runs may have been filtered out) */
+            fft_execute(plan, input, parallel);
+            fft_set_parallel_threshold(0);
+            fft_execute(plan, input, serial);
+            if (memcmp(serial, parallel, sizeof(complex_t) * n) != 0) {
+                fprintf(stderr, "fft_threads/%d: parallel output differs from serial\n", n);
+            }
+        }
+        fft_plan_destroy(plan);
+        free(input);
+        free(serial);
+        free(parallel);
+    }
+    fft_set_parallel_threshold(FFT_PARALLEL_MIN_N);
+}
+
+static void bench_online_dft(bench_t *bench)
+{
+    static const int sizes[] = { 1000, 4000, 16000 };
+    int count = (int)(sizeof(sizes) / sizeof(sizes[0]));
+    char name[96];
+
+    for (int i = 0; i < count; i++) {
+        int n = sizes[i];
+        online_ctx_t ctx;
+        online_dft_init(&ctx.od);
+        point_list_init(&ctx.points, NULL);
+        complex_t *signal = (complex_t *)malloc(sizeof(complex_t) * (n + 1));
+        if (signal && point_list_reserve(&ctx.points, n + 1)) {
+            make_signal(signal, n + 1);
+            for (int j = 0; j <= n; j++) {
+                ctx.points.data[j] = (Vector2){ signal[j].real, signal[j].imag };
+            }
+
+            /* Grid sized for the drawing so far, as it is mid-stroke */
+            ctx.points.count = n;
+            online_dft_update(&ctx.od, &ctx.points);
+            ctx.output = (complex_t *)malloc(sizeof(complex_t) * ctx.od.size);
+
+            if (ctx.output && ctx.od.size > n) {
+                snprintf(name, sizeof(name), "online_dft_point/%d", n);
+                bench_run(bench, name, op_online_dft_point, &ctx, 1, "points");
+                snprintf(name, sizeof(name), "online_dft_spectrum/%d", n);
+                bench_run(bench, name, op_online_dft_spectrum, &ctx, ctx.od.size, "bins");
+            }
+            free(ctx.output);
+        }
+        free(signal);
+        point_list_free(&ctx.points);
+        online_dft_free(&ctx.od);
+    }
+}
+
+static void bench_epicycles(bench_t *bench)
+{
+    static const int terms[] = { 16, 64, 256, 1024, 4096, 16384 };
+    int count = (int)(sizeof(terms) / sizeof(terms[0]));
+    int max_terms = terms[count - 1];
+    char name[96];
+
+    /* Real epicycles of the test signal, sorted like the app sorts them */
+    complex_t *signal = (complex_t *)malloc(sizeof(complex_t) * max_terms);
+    if (!signal) return;
+    make_signal(signal, max_terms);
+    complex_t *dft = DFT(signal, max_terms);
+    epicycle_t *epic = dft ? dft_to_epicycles(dft, max_terms, true) : NULL;
+    free(signal);
+    mem_free(dft);
+    if (!epic) return;
+
+    for (int i = 0; i < count; i++) {
+        epicycle_ctx_t ctx;
+        memset(&ctx, 0, sizeof(ctx));
+        ctx.epic = epic;
+        ctx.terms = terms[i];
+        ctx.dt = 2 * PI / 2048;
+        epicycle_soa_init(&ctx.soa);
+        epicycle_eval_init(&ctx.eval);
+        if (!epicycle_soa_load(&ctx.soa, epic, terms[i]) ||
+            !epicycle_eval_setup(&ctx.eval, epic, terms[i], ctx.dt)) {
+            epicycle_soa_free(&ctx.soa);
+            epicycle_eval_free(&ctx.eval);
+            continue;
+        }
+
+        snprintf(name, sizeof(name), "epicycles_position/%d", terms[i]);
+        bench_run(bench, name, op_epicycles_position, &ctx, terms[i], "terms");
+
+        snprintf(name, sizeof(name), "epicycle_soa_position/%s/%d",
+                 simd_path_name(simd_active_path()), terms[i]);
+        bench_run(bench, name, op_soa_position, &ctx, terms[i], "terms");
+
+        snprintf(name, sizeof(name), "epicycle_eval_step/%d", terms[i]);
+        bench_run(bench, name, op_eval_step, &ctx, terms[i], "terms");
+
+        epicycle_soa_free(&ctx.soa);
+        epicycle_eval_free(&ctx.eval);
+    }
+    mem_free(epic);
+}
+
+static void bench_shapes(bench_t *bench, const char *dir)
+{
+    file_list_t files;
+    char name[96];
+    files.count = 0;
+    if (platform_list_dir(dir, collect_file, &files) < 0) {
+        fprintf(stderr, "Could not read shape directory: %s\n", dir);
+        return;
+    }
+    qsort(files.paths, (size_t)files.count, sizeof(char *), compare_paths);
+
+    /* Heap-backed and reused across ops, so steady-state runs allocate nothing */
+    point_list_t points;
+    point_list_t resampled;
+    point_list_init(&points, NULL);
+    point_list_init(&resampled, NULL);
+
+    for (int i = 0; i < files.count; i++) {
+        const char *path = files.paths[i];
+        bool svg = has_extension(path, ".svg");
+        if (!svg && !has_extension(path, ".txt")) continue;
+
+        /* Skip files the loaders reject (e.g. shapes/README.txt) */
+        load_ctx_t load = { path, &points, svg };
+        op_load_file(&load);
+        int point_count = points.count;
+        if (point_count <= 0) continue;
+
+        if (svg) {
+            char *text = read_text_file(path);
+            svg_reader_t reader;
+            svg_reader_init(&reader, text, text ? strlen(text) : 0);
+            int d_len = 0;
+            const char *d = svg_next_path(&reader, &d_len);
+            if (d) {
+                parse_ctx_t parse = { d, d_len, &points };
+                snprintf(name, sizeof(name), "parse_svg_path/%s", base_name(path));
+                bench_run(bench, name, op_parse_svg_path, &parse, d_len, "bytes");
+            }
+            free(text);
+
+            snprintf(name, sizeof(name), "load_svg_file/%s", base_name(path));
+        } else {
+            snprintf(name, sizeof(name), "load_shape_from_file/%s", base_name(path));
+        }
+        bench_run(bench, name, op_load_file, &load, point_count, "points");
+
+        /* Arc-length resampling to the power-of-two transform size */
+        resample_ctx_t resample = { &points, &resampled, resample_target(RESAMPLE_POW2, point_count, 0) };
+        snprintf(name, sizeof(name), "resample/%s", base_name(path));
+        bench_run(bench, name, op_resample, &resample, point_count, "points");
+    }
+
+    point_list_free(&points);
+    point_list_free(&resampled);
+    for (int i = 0; i < files.count; i++) free(files.paths[i]);
+}
+
+/* Number scanning on its own: dragon.svg's path data and a generated TXT shape */
+static void bench_numbers(bench_t *bench, const char *dir)
+{
+    char path[512];
+    snprintf(path, sizeof(path), "%s/dragon.svg", dir);
+    char *text = read_text_file(path);
+    svg_reader_t reader;
+    svg_reader_init(&reader, text, text ? strlen(text) : 0);
+    int d_len = 0;
+    const char *d = svg_next_path(&reader, &d_len);
+    if (d) {
+        /* Numbers only: drop the command letters so both scanners see the same input */
+        char *numbers = (char *)malloc((size_t)d_len + 1);
+        if (numbers) {
+            for (int i = 0; i < d_len; i++) {
+                char ch = d[i];
+                bool letter = (ch >= 'a' && ch <= 'z' && ch != 'e') || (ch >= 'A' && ch <= 'Z' && ch != 'E');
+                numbers[i] = letter ? ' ' : ch;
+            }
+            numbers[d_len] = '\0';
+            number_ctx_t ctx = { numbers, (size_t)d_len };
+            bench_run(bench, "numbers/strtof/dragon.svg", op_numbers_strtof, &ctx, d_len, "bytes");
+            bench_run(bench, "numbers/scan_float/dragon.svg", op_numbers_scan_float, &ctx, d_len, "bytes");
+            free(numbers);
+        }
+    }
+    free(text);
+
+    /* 20000 points with four decimals, as exported by tracing tools */
+    int lines = 20000;
+    size_t size = (size_t)lines * 32 + 1;
+    char *txt = (char *)malloc(size);
+    if (txt) {
+        size_t len = 0;
+        for (int i = 0; i < lines; i++) {
+            float t = (2 * PI * i) / lines;
+            len += (size_t)snprintf(txt + len, size - len, "%.4f %.4f\n", 300.0f * cosf(t), 200.0f * sinf(3 * t));
+        }
+        number_ctx_t ctx = { txt, len };
+        bench_run(bench, "numbers/sscanf/txt_20000", op_lines_sscanf, &ctx, lines, "lines");
+        bench_run(bench, "numbers/scan_float/txt_20000", op_lines_scan_float, &ctx, lines, "lines");
+        free(txt);
+    }
+}
+
+/* Per-command cost of the path parser: 4096 of one command after a moveto, in the
+ * form exporters write them (implicit repeats, relative coordinates where usual) */
+static void bench_path_commands(bench_t *bench)
+{
+    static const struct { const char *name; const char *first; const char *repeat; } kinds[] = {
+        { "L", "L", " 12.5 -3.25" },
+        { "H", "h", " 12.5" },
+        { "V", "v", " -3.25" },
+        { "C", "c", " 4.5 1.25 8.5 -2.75 12.5 -3.25" },
+        { "S", "s", " 8.5 -2.75 12.5 -3.25" },
+        { "Q", "q", " 6.25 4.5 12.5 -3.25" },
+        { "T", "t", " 12.5 -3.25" },
+        { "A", "a", " 8 5 30 0 1 12.5 -3.25" },
+        { "Z", "", "Z" },
+    };
+    int repeats = 4096;
+    char name[96];
+    point_list_t points;
+    point_list_init(&points, NULL);
+
+    for (int i = 0; i < (int)(sizeof(kinds) / sizeof(kinds[0])); i++) {
+        size_t size = 16 + strlen(kinds[i].first) + (size_t)repeats * strlen(kinds[i].repeat);
+        char *d = (char *)malloc(size);
+        if (!d) break;
+        int len = snprintf(d, size, "M0 0%s", kinds[i].first);
+        for (int j = 0; j < repeats; j++) {
+            len += snprintf(d + len, size - (size_t)len, "%s", kinds[i].repeat);
+        }
+
+        parse_ctx_t parse = { d, len, &points };
+        snprintf(name, sizeof(name), "path_command/%s", kinds[i].name);
+        bench_run(bench, name, op_parse_svg_path, &parse, repeats, "commands");
+        free(d);
+    }
+    point_list_free(&points);
+}
+
+/* Icon-set sized documents: many <path> elements (dragon's path data) inside groups and
+ * definitions. Throughput should hold steady as the document grows (linear-time load). */
+static void bench_svg_documents(bench_t *bench, const char *dir)
+{
+    /* The last run repeats 128 paths with every group transformed: a transform should cost
+     * next to nothing, since it is applied as the points are made */
+    static const int path_counts[] = { 8, 128, 1024, 128 };
+    int count = (int)(sizeof(path_counts) / sizeof(path_counts[0]));
+    char path[512];
+    char name[96];
+    snprintf(path, sizeof(path), "%s/dragon.svg", dir);
+
+    char *text = read_text_file(path);
+    svg_reader_t reader;
+    svg_reader_init(&reader, text, text ? strlen(text) : 0);
+    int d_len = 0;
+    const char *d = svg_next_path(&reader, &d_len);
+    if (!d) { free(text); return; }
+
+    point_list_t points;
+    point_list_init(&points, NULL);
+    for (int i = 0; i < count; i++) {
+        int paths = path_counts[i];
+        bool transformed = i == count - 1;
+        size_t size = 128 + (size_t)paths * ((size_t)d_len + 160);
+        char *svg = (char *)malloc(size);
+        if (!svg) break;
+
+        int len = snprintf(svg, size, "<svg xmlns=\"http://www.w3.org/2000/svg\"%s><!-- icons -->",
+                           transformed ? " viewBox=\"0 0 480 360\" width=\"960\" height=\"540\"" : "");
+        for (int j = 0; j < paths; j++) {
+            /* Every eighth path is a definition and must be skipped */
+            if (j % 8 == 7) {
+                len += snprintf(svg + len, size - (size_t)len, "<defs><path d=\"%.*s\"/></defs>\n", d_len, d);
+            } else if (transformed) {
+                len += snprintf(svg + len, size - (size_t)len,
+                                "<g transform=\"translate(%d %d) rotate(%d)\"><path fill=\"#000\" transform=\"scale(0.5)\" d=\"%.*s\"/></g>\n",
+                                j % 16 * 30, j / 16 * 40, j * 7 % 360, d_len, d);
+            } else {
+                len += snprintf(svg + len, size - (size_t)len, "<g><path fill=\"#000\" d=\"%.*s\"/></g>\n", d_len, d);
+            }
+        }
+        len += snprintf(svg + len, size - (size_t)len, "</svg>");
+
+        svg_doc_ctx_t ctx = { svg, (size_t)len, &points };
+        snprintf(name, sizeof(name), "svg_document/%d_paths%s", paths, transformed ? "_transformed" : "");
+        bench_run(bench, name, op_svg_document, &ctx, len, "bytes");
+        free(svg);
+    }
+    point_list_free(&points);
+    free(text);
+}
+
+/* The app's restart and reload paths; both should report 0 allocs/op once warm */
+static void bench_app(bench_t *bench, const char *dir)
+{
+    static AppState state;
+    char path[512];
+    char name[96];
+    snprintf(path, sizeof(path), "%s/dragon.svg", dir);
+
+    app_state_init(&state);
+    if (load_svg_file(&state.drawing_points, path, 700.0f, 500.0f, DEFAULT_LOAD_SCALE) > 0) {
+        app_ctx_t ctx = { &state, path };
+        snprintf(name, sizeof(name), "app_start_animation/%s", base_name(path));
+        bench_run(bench, name, op_app_start, &ctx, state.drawing_points.count, "points");
+
+        snprintf(name, sizeof(name), "app_reload/%s", base_name(path));
+        bench_run(bench, name, op_app_reload, &ctx, state.drawing_points.count, "points");
+
+        /* A large load, transformed vs started from the coefficient cache (the run stores it) */
+        state.resample_mode = RESAMPLE_FIXED;
+        state.resample_points = 50000;
+        state.coef_cache_dir = FCOEF_CACHE_DIR;
+        app_resample_input(&state);
+        int n = state.drawing_points.count;
+        snprintf(name, sizeof(name), "coef_cache/transform/%s_%d", base_name(path), n);
+        bench_run(bench, name, op_app_start, &ctx, n, "points");
+
+        if (!app_start_animation_cached(&state)) app_start_animation(&state);
+        if (app_start_animation_cached(&state)) {
+            snprintf(name, sizeof(name), "coef_cache/hit/%s_%d", base_name(path), n);
+            bench_run(bench, name, op_app_start_cached, &ctx, n, "points");
+        }
+    }
+    app_state_free(&state);
+}
+
+/* ========== Output ========== */
+
+static void write_json(FILE *out, const bench_t *bench, const char *label)
+{
+    fprintf(out, "{\n  \"label\": \"%s\",\n  \"kernel\": \"%s\",\n  \"samples\": %d,\n  \"benchmarks\": [",
+            label, simd_path_name(simd_active_path()), bench->samples);
+    for (int i = 0; i < bench->result_count; i++) {
+        const bench_result_t *r = &bench->results[i];
+        fprintf(out, "%s\n    { \"name\": \"%s\", \"ns_per_op\": %.2f, \"ns_min\": %.2f, "
+                     "\"items_per_op\": %.0f, \"unit\": \"%s\", \"items_per_sec\": %.6g, "
+                     "\"allocs_per_op\": %.3f, \"iterations\": %lld }",
+                i ? "," : "", r->name, r->ns_per_op, r->ns_min, r->items_per_op, r->unit,
+                r->items_per_sec, r->allocs_per_op, r->iterations);
+    }
+    fprintf(out, "\n  ]\n}\n");
+}
+
+static void write_csv(FILE *out, const bench_t *bench, const char *label)
+{
+    fprintf(out, "label,name,ns_per_op,ns_min,items_per_op,unit,items_per_sec,allocs_per_op,iterations\n");
+    for (int i = 0; i < bench->result_count; i++) {
+        const bench_result_t *r = &bench->results[i];
+        fprintf(out, "%s,%s,%.2f,%.2f,%.0f,%s,%.6g,%.3f,%lld\n", label, r->name, r->ns_per_op,
+                r->ns_min, r->items_per_op, r->unit, r->items_per_sec, r->allocs_per_op, r->iterations);
+    }
+}
+
+/* ========== Main Entry Point ========== */
+
+static void print_usage(void)
+{
+    fprintf(stderr,
+        "Usage: fourier_bench [options]\n"
+        "  --format json|csv   Output format (default: json)\n"
+        "  --out PATH          Output file (default: stdout)\n"
+        "  --filter TEXT       Only run benchmarks whose name contains TEXT\n"
+        "  --shapes DIR        Shape directory (default: shapes)\n"
+        "  --min-time SEC      Minimum duration of one sample (default: 0.02)\n"
+        "  --samples N         Samples per benchmark (default: 5)\n"
+        "  --label TEXT        Run label stored in the output (e.g. a commit id)\n"
+        "  --threads N         Task pool threads for large transforms (default: all cores)\n");
+}
+
+int main(int argc, char **argv)
+{
+    static bench_t bench;
+    const char *format = "json";
+    const char *out_path = NULL;
+    const char *shapes_dir = "shapes";
+    const char *label = "";
+    bench.min_time = 0.02;
+    bench.samples = 5;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if      (strcmp(arg, "--format") == 0 && has_value)   format = argv[++i];
+        else if (strcmp(arg, "--out") == 0 && has_value)      out_path = argv[++i];
+        else if (strcmp(arg, "--filter") == 0 && has_value)   bench.filter = argv[++i];
+        else if (strcmp(arg, "--shapes") == 0 && has_value)   shapes_dir = argv[++i];
+        else if (strcmp(arg, "--min-time") == 0 && has_value) bench.min_time = atof(argv[++i]);
+        else if (strcmp(arg, "--samples") == 0 && has_value)  bench.samples = atoi(argv[++i]);
+        else if (strcmp(arg, "--label") == 0 && has_value)    label = argv[++i];
+        else if (strcmp(arg, "--threads") == 0 && has_value)  task_pool_set_threads(atoi(argv[++i]));
+        else { print_usage(); return 2; }
+    }
+
+    bool csv = strcmp(format, "csv") == 0;
+    if (!csv && strcmp(format, "json") != 0) { print_usage(); return 2; }
+    if (bench.samples < 1) bench.samples = 1;
+    if (bench.samples > BENCH_MAX_SAMPLES) bench.samples = BENCH_MAX_SAMPLES;
+
+    simd_init();
+    shapes_set_verbose(false);
+    fprintf(stderr, "Epicycle kernel: %s\n", simd_path_name(simd_active_path()));
+
+    bench_dft(&bench);
+    bench_fft_threads(&bench);
+    bench_online_dft(&bench);
+    bench_epicycles(&bench);
+    bench_shapes(&bench, shapes_dir);
+    bench_path_commands(&bench);
+    bench_svg_documents(&bench, shapes_dir);
+    bench_numbers(&bench, shapes_dir);
+    bench_app(&bench, shapes_dir);
+
+    FILE *out = out_path ? fopen(out_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Could not open output file: %s\n", out_path);
+        return 1;
+    }
+    if (csv) write_csv(out, &bench, label);
+    else     write_json(out, &bench, label);
+    if (out != stdout) fclose(out);
+    task_pool_shutdown();
+    return 0;
+}
@@ -0,0 +1,410 @@
+/**
+ * cli.c - Headless Batch Tool
+ *
+ * Runs load -> transform -> reconstruct on shape files without opening a
+ * window, and writes coefficients, reconstruction error and timing per shape.
+ * Links only the pipeline (fourier, fft, simd, shapes, platform), not raylib.
+ *
+ * Usage:
+ *   fourier_cli [options] <file-or-directory>...
+ *
+ * Options:
+ *   --format json|csv   Output format (default: json)
+ *   --out PATH          Output file (default: stdout)
+ *   --coeffs PATH       CSV mode: also write coefficients to PATH
+ *   --threads N         Worker threads (default: all cores)
+ *   --energy F          Energy fraction kept by the term budget (default: 0.999)
+ *   --unsigned          Use frequencies 0..N-1 instead of signed ones
+ *   --all-terms         Write all N coefficients, not just the kept top-K
+ *   --resample M|pow2   Resample each shape to M (or the nearest power of two)
+ *                       points evenly spaced by arc length before the transform
+ *   --flatten PX        Largest gap between an SVG curve and its chords, in pixels
+ *                       of the loaded shape (default: 0.25)
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+#include "fourier.h"
+#include "shapes.h"
+#include "simd.h"
+#include "mem.h"
+#include "platform.h"
+#include "task_pool.h"
+#include <string.h>
+
+/* ========== Types ========== */
+
+typedef struct {
+    const char *path;
+    bool ok;
+    bool skipped;               /* Readable, but no points in it (notes, empty files) */
+    int points;
+    int terms;
+    double load_ms;
+    double transform_ms;
+    double reconstruct_ms;
+    double rms_error;
+    double max_error;
+    epicycle_t *epicycles;      /* All N terms, sorted */
+} shape_job_t;
+
+typedef struct {
+    shape_job_t *jobs;
+    int job_count;
+    volatile int next_job;
+    float energy_fraction;
+    bool centered;
+    resample_mode_t resample_mode;
+    int resample_points;
+} batch_t;
+
+typedef struct {
+    char **paths;
+    int count;
+    int capacity;
+} path_list_t;
+
+/* ========== Helpers ========== */
+
+static bool has_extension(const char *path, const char *ext)
+{
+    size_t len = strlen(path);
+    size_t ext_len = strlen(ext);
+    if (len <= ext_len) return false;
+
+    const char *p = path + len - ext_len;
+    for (size_t i = 0; i < ext_len; i++) {
+        char c = p[i];
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        if (c != ext[i]) return false;
+    }
+    return true;
+}
+
+static void path_list_add(const char *path, void *user)
+{
+    path_list_t *list = (path_list_t *)user;
+    if (!has_extension(path, ".svg") && !has_extension(path, ".txt")) return;
+
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 16;
+        char **paths = (char **)mem_realloc(list->paths, sizeof(char *) * capacity);
+        if (!paths) return;
+        list->paths = paths;
+        list->capacity = capacity;
+    }
+    size_t len = strlen(path);
+    char *copy = (char *)mem_alloc(len + 1);
+    if (!copy) return;
+    memcpy(copy, path, len + 1);
+    list->paths[list->count++] = copy;
+}
+
+/* Tells a file without points apart from one that could not be read (both load 0 points) */
+static bool is_readable(const char *path)
+{
+    platform_file_map_t map;
+    if (!platform_map_file(path, &map)) return false;
+    platform_unmap_file(&map);
+    return true;
+}
+
+static int compare_paths(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static void write_json_string(FILE *out, const char *s)
+{
+    fputc('"', out);
+    for (; *s; s++) {
+        switch (*s) {
+            case '"':  fputs("\\\"", out); break;
+            case '\\': fputs("\\\\", out); break;
+            case '\n': fputs("\\n", out); break;
+            case '\t': fputs("\\t", out); break;
+            default:
+                if ((unsigned char)*s < 0x20) fprintf(out, "\\u%04x", *s);
+                else fputc(*s, out);
+                break;
+        }
+    }
+    fputc('"', out);
+}
+
+/* CSV field: quoted, with embedded quotes doubled */
+static void write_csv_string(FILE *out, const char *s)
+{
+    fputc('"', out);
+    for (; *s; s++) {
+        if (*s == '"') fputc('"', out);
+        fputc(*s, out);
+    }
+    fputc('"', out);
+}
+
+/* ========== Pipeline ========== */
+
+static void run_job(shape_job_t *job, const batch_t *batch)
+{
+    point_list_t list;
+    point_list_init(&list, NULL);
+
+    /* Load */
+    double t0 = platform_time_seconds();
+    int n = 0;
+    if (has_extension(job->path, ".svg")) {
+        n = load_svg_file(&list, job->path, 0.0f, 0.0f, DEFAULT_LOAD_SCALE);
+    } else {
+        n = load_shape_from_file(&list, job->path, 0.0f, 0.0f, DEFAULT_LOAD_SCALE);
+    }
+    double t1 = platform_time_seconds();
+    job->load_ms = (t1 - t0) * 1000.0;
+    job->points = n;
+    if (n <= 0) {
+        job->skipped = is_readable(job->path);
+        point_list_free(&list);
+        return;
+    }
+
+    /* Even arc-length spacing; the error below is then measured against the samples */
+    int m = resample_target(batch->resample_mode, n, batch->resample_points);
+    if (m > 0) {
+        point_list_t resampled;
+        point_list_init(&resampled, NULL);
+        if (!point_list_resample(&list, &resampled, m)) {
+            point_list_free(&resampled);
+            point_list_free(&list);
+            return;
+        }
+        point_list_free(&list);
+        list = resampled;
+        n = m;
+        job->points = n;
+    }
+    const Vector2 *points = list.data;
+
+    /* Transform */
+    complex_t *samples = (complex_t *)mem_alloc(sizeof(complex_t) * n);
+    if (!samples) { point_list_free(&list); return; }
+    for (int i = 0; i < n; i++) {
+        samples[i].real = points[i].x;
+        samples[i].imag = points[i].y;
+    }
+    complex_t *dft = DFT(samples, n);
+    epicycle_t *epic = dft ? dft_to_epicycles(dft, n, batch->centered) : NULL;
+    mem_free(samples);
+    mem_free(dft);
+    if (!epic) { point_list_free(&list); return; }
+    job->terms = epicycles_terms_for_energy(epic, n, batch->energy_fraction);
+    double t2 = platform_time_seconds();
+    job->transform_ms = (t2 - t1) * 1000.0;
+
+    /* Reconstruct the top-K series at every sample instant */
+    epicycle_soa_t soa;
+    epicycle_soa_init(&soa);
+    if (epicycle_soa_load(&soa, epic, job->terms)) {
+        double sum_sq = 0.0;
+        double max_err = 0.0;
+        for (int i = 0; i < n; i++) {
+            Vector2 p = epicycle_soa_position(&soa, (2 * PI * i) / n);
+            double dx = (double)p.x - points[i].x;
+            double dy = (double)p.y - points[i].y;
+            double err = sqrt(dx * dx + dy * dy);
+            sum_sq += err * err;
+            if (err > max_err) max_err = err;
+        }
+        job->rms_error = sqrt(sum_sq / n);
+        job->max_error = max_err;
+        job->ok = true;
+    }
+    epicycle_soa_free(&soa);
+    job->reconstruct_ms = (platform_time_seconds() - t2) * 1000.0;
+
+    job->epicycles = epic;
+    point_list_free(&list);
+}
+
+static void worker_main(void *arg)
+{
+    batch_t *batch = (batch_t *)arg;
+
+    for (;;) {
+        int index = platform_atomic_add(&batch->next_job, 1) - 1;
+        if (index >= batch->job_count) break;
+        run_job(&batch->jobs[index], batch);
+    }
+}
+
+/* ========== Output ========== */
+
+static void write_json(FILE *out, const batch_t *batch, bool all_terms)
+{
+    fprintf(out, "{\n  \"kernel\": \"%s\",\n  \"energy_fraction\": %.6g,\n  \"centered\": %s,\n  \"shapes\": [",
+            simd_path_name(simd_active_path()), batch->energy_fraction, batch->centered ? "true" : "false");
+
+    for (int j = 0; j < batch->job_count; j++) {
+        const shape_job_t *job = &batch->jobs[j];
+        fprintf(out, "%s\n    {\n      \"file\": ", j ? "," : "");
+        write_json_string(out, job->path);
+        fprintf(out, ",\n      \"ok\": %s,\n      \"skipped\": %s,\n      \"points\": %d,\n      \"terms\": %d,\n",
+                job->ok ? "true" : "false", job->skipped ? "true" : "false", job->points, job->terms);
+        fprintf(out, "      \"timing_ms\": { \"load\": %.4f, \"transform\": %.4f, \"reconstruct\": %.4f },\n",
+                job->load_ms, job->transform_ms, job->reconstruct_ms);
+        fprintf(out, "      \"error\": { \"rms\": %.6g, \"max\": %.6g },\n", job->rms_error, job->max_error);
+        fprintf(out, "      \"coefficients\": [");
+
+        int count = job->epicycles ? (all_terms ? job->points : job->terms) : 0;
+        for (int k = 0; k < count; k++) {
+            const epicycle_t *e = &job->epicycles[k];
+            fprintf(out, "%s[%g, %.9g, %.9g]", k ? ", " : "", e->frequency, e->amplitude, e->phase);
+        }
+        fprintf(out, "]\n    }");
+    }
+    fprintf(out, "\n  ]\n}\n");
+}
+
+static void write_csv(FILE *out, FILE *coeffs, const batch_t *batch, bool all_terms)
+{
+    fprintf(out, "file,ok,skipped,points,terms,load_ms,transform_ms,reconstruct_ms,rms_error,max_error\n");
+    for (int j = 0; j < batch->job_count; j++) {
+        const shape_job_t *job = &batch->jobs[j];
+        write_csv_string(out, job->path);
+        fprintf(out, ",%d,%d,%d,%d,%.4f,%.4f,%.4f,%.6g,%.6g\n", job->ok ? 1 : 0,
+                job->skipped ? 1 : 0, job->points, job->terms, job->load_ms, job->transform_ms,
+                job->reconstruct_ms, job->rms_error, job->max_error);
+    }
+
+    if (!coeffs) return;
+    fprintf(coeffs, "file,rank,frequency,amplitude,phase\n");
+    for (int j = 0; j < batch->job_count; j++) {
+        const shape_job_t *job = &batch->jobs[j];
+        int count = job->epicycles ? (all_terms ? job->points : job->terms) : 0;
+        for (int k = 0; k < count; k++) {
+            const epicycle_t *e = &job->epicycles[k];
+            write_csv_string(coeffs, job->path);
+            fprintf(coeffs, ",%d,%g,%.9g,%.9g\n", k, e->frequency, e->amplitude, e->phase);
+        }
+    }
+}
+
+/* ========== Main Entry Point ========== */
+
+static void print_usage(void)
+{
+    fprintf(stderr,
+        "Usage: fourier_cli [options] <file-or-directory>...\n"
+        "  --format json|csv   Output format (default: json)\n"
+        "  --out PATH          Output file (default: stdout)\n"
+        "  --coeffs PATH       CSV mode: also write coefficients to PATH\n"
+        "  --threads N         Worker threads (default: all cores)\n"
+        "  --energy F          Energy fraction kept by the term budget (default: %.3f)\n"
+        "  --unsigned          Use frequencies 0..N-1 instead of signed ones\n"
+        "  --all-terms         Write all N coefficients, not just the kept top-K\n"
+        "  --resample M|pow2   Resample to M (or the nearest power of two) points by arc length\n"
+        "  --flatten PX        SVG curve flattening tolerance in pixels (default: %.2f)\n",
+        DEFAULT_ENERGY_FRACTION, SVG_FLATTEN_TOLERANCE);
+}
+
+int main(int argc, char **argv)
+{
+    const char *format = "json";
+    const char *out_path = NULL;
+    const char *coeffs_path = NULL;
+    int threads = platform_cpu_count();
+    bool all_terms = false;
+    path_list_t inputs = { 0 };
+    batch_t batch = { 0 };
+    batch.energy_fraction = DEFAULT_ENERGY_FRACTION;
+    batch.centered = true;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if      (strcmp(arg, "--format") == 0 && has_value)  format = argv[++i];
+        else if (strcmp(arg, "--out") == 0 && has_value)     out_path = argv[++i];
+        else if (strcmp(arg, "--coeffs") == 0 && has_value)  coeffs_path = argv[++i];
+        else if (strcmp(arg, "--threads") == 0 && has_value) threads = atoi(argv[++i]);
+        else if (strcmp(arg, "--energy") == 0 && has_value)  batch.energy_fraction = (float)atof(argv[++i]);
+        else if (strcmp(arg, "--unsigned") == 0)             batch.centered = false;
+        else if (strcmp(arg, "--all-terms") == 0)            all_terms = true;
+        else if (strcmp(arg, "--flatten") == 0 && has_value) shapes_set_flatten_tolerance((float)atof(argv[++i]));
+        else if (strcmp(arg, "--resample") == 0 && has_value) {
+            const char *value = argv[++i];
+            if (strcmp(value, "pow2") == 0) {
+                batch.resample_mode = RESAMPLE_POW2;
+            } else {
+                batch.resample_mode = RESAMPLE_FIXED;
+                batch.resample_points = atoi(value);
+                if (batch.resample_points <= 0) { print_usage(); return 2; }
+            }
+        }
+        else if (arg[0] == '-') { print_usage(); return 2; }
+        else if (platform_is_dir(arg)) {
+            if (platform_list_dir(arg, path_list_add, &inputs) < 0) {
+                fprintf(stderr, "Could not read directory: %s\n", arg);
+            }
+        } else {
+            path_list_add(arg, &inputs);
+        }
+    }
+
+    bool csv = strcmp(format, "csv") == 0;
+    if ((!csv && strcmp(format, "json") != 0) || inputs.count == 0) {
+        print_usage();
+        return 2;
+    }
+    qsort(inputs.paths, (size_t)inputs.count, sizeof(char *), compare_paths);
+
+    simd_init();
+
+    /* Run every shape across the worker threads */
+    batch.jobs = (shape_job_t *)mem_calloc((size_t)inputs.count, sizeof(shape_job_t));
+    if (!batch.jobs) return 1;
+    batch.job_count = inputs.count;
+    for (int j = 0; j < inputs.count; j++) batch.jobs[j].path = inputs.paths[j];
+
+    if (threads < 1) threads = 1;
+    if (threads > inputs.count) threads = inputs.count;
+
+    double start = platform_time_seconds();
+    platform_thread_t **workers = (platform_thread_t **)mem_calloc((size_t)threads, sizeof(platform_thread_t *));
+    for (int i = 1; workers && i < threads; i++) {
+        workers[i] = platform_thread_start(worker_main, &batch);
+    }
+    worker_main(&batch);     /* The main thread works too */
+    for (int i = 1; workers && i < threads; i++) {
+        platform_thread_join(workers[i]);
+    }
+    mem_free(workers);
+    double elapsed = platform_time_seconds() - start;
+
+    /* Write results in input order */
+    FILE *out = out_path ? fopen(out_path, "w") : stdout;
+    FILE *coeffs = (csv && coeffs_path) ? fopen(coeffs_path, "w") : NULL;
+    if (!out) {
+        fprintf(stderr, "Could not open output file: %s\n", out_path);
+        return 1;
+    }
+    if (csv) write_csv(out, coeffs, &batch, all_terms);
+    else     write_json(out, &batch, all_terms);
+    if (out != stdout) fclose(out);
+    if (coeffs) fclose(coeffs);
+
+    /* Only load and transform errors fail the run; inputs without points are skipped */
+    int failed = 0;
+    int skipped = 0;
+    for (int j = 0; j < batch.job_count; j++) {
+        if (batch.jobs[j].skipped) skipped++;
+        else if (!batch.jobs[j].ok) failed++;
+        mem_free(batch.jobs[j].epicycles);
+        mem_free(inputs.paths[j]);
+    }
+    fprintf(stderr, "Processed %d shapes (%d skipped, %d failed) on %d threads in %.1f ms\n",
+            batch.job_count, skipped, failed, threads, elapsed * 1000.0);
+
+    mem_free(batch.jobs);
+    mem_free(inputs.paths);
+    task_pool_shutdown();
+    return failed ? 1 : 0;
+}
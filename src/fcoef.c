@@ -0,0 +1,119 @@
+/**
+ * fcoef.c - Coefficient Cache Implementation
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+#include "fcoef.h"
+#include <string.h>
+
+#define FCOEF_BYTE_ORDER  0x01020304u
+#define FCOEF_MAX_PATH    512
+
+static const char fcoef_magic[4] = { 'F', 'C', 'O', 'E' };
+
+/* Distinguishes the temporary files of stores running at the same time */
+static volatile int store_serial = 0;
+
+/* ========== Keys and Paths ========== */
+
+/*
+ * FNV-1a over 64-bit words instead of bytes: one multiply per point rather
+ * than eight, with a shift after each so the high bits of a word (float
+ * signs and exponents) reach the low bits of the hash too.
+ */
+static uint64_t hash_words(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    for (; size >= 8; p += 8, size -= 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        hash = (hash ^ word) * 0x100000001b3ull;
+        hash ^= hash >> 32;
+    }
+    for (; size > 0; p++, size--) {
+        hash = (hash ^ *p) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+uint64_t fcoef_key(const point_list_t *points)
+{
+    int32_t count = points->count;
+    uint64_t hash = hash_words(0xcbf29ce484222325ull, &count, sizeof(count));
+    return hash_words(hash, points->data, sizeof(Vector2) * (size_t)points->count);
+}
+
+static bool cache_path(char *path, size_t size, const char *dir, uint64_t key)
+{
+    int len = snprintf(path, size, "%s/%016llx.fcoef", dir, (unsigned long long)key);
+    return len > 0 && (size_t)len < size;
+}
+
+static size_t file_size(int count)
+{
+    return sizeof(fcoef_header_t) + (sizeof(complex_t) + sizeof(epicycle_t)) * (size_t)count;
+}
+
+/* ========== Reading ========== */
+
+bool fcoef_open(const char *dir, uint64_t key, int count, fcoef_file_t *file)
+{
+    char path[FCOEF_MAX_PATH];
+    memset(file, 0, sizeof(*file));
+    if (count <= 0 || !cache_path(path, sizeof(path), dir, key)) return false;
+    if (!platform_map_file(path, &file->map)) return false;
+
+    /* The mapping is page aligned, so the header and both arrays are aligned too */
+    const fcoef_header_t *header = (const fcoef_header_t *)file->map.data;
+    if (file->map.size != file_size(count) ||
+        memcmp(header->magic, fcoef_magic, sizeof(fcoef_magic)) != 0 ||
+        header->version != FCOEF_VERSION || header->byte_order != FCOEF_BYTE_ORDER ||
+        header->key != key || header->count != count) {
+        fcoef_close(file);
+        return false;
+    }
+
+    file->count = count;
+    file->centered = (header->flags & FCOEF_CENTERED) != 0;
+    file->spectrum = (const complex_t *)(file->map.data + sizeof(fcoef_header_t));
+    file->epicycles = (const epicycle_t *)(file->spectrum + count);
+    return true;
+}
+
+void fcoef_close(fcoef_file_t *file)
+{
+    platform_unmap_file(&file->map);
+    memset(file, 0, sizeof(*file));
+}
+
+/* ========== Writing ========== */
+
+bool fcoef_store(const char *dir, uint64_t key, const complex_t *spectrum,
+                 const epicycle_t *epicycles, int count, bool centered)
+{
+    char path[FCOEF_MAX_PATH];
+    char temp[FCOEF_MAX_PATH + 32];
+    if (count <= 0 || !cache_path(path, sizeof(path), dir, key)) return false;
+    if (!platform_make_dir(dir)) return false;
+    snprintf(temp, sizeof(temp), "%s.%d.tmp", path, platform_atomic_add(&store_serial, 1));
+
+    fcoef_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, fcoef_magic, sizeof(fcoef_magic));
+    header.version = FCOEF_VERSION;
+    header.byte_order = FCOEF_BYTE_ORDER;
+    header.flags = centered ? FCOEF_CENTERED : 0u;
+    header.key = key;
+    header.count = count;
+
+    FILE *out = fopen(temp, "wb");
+    if (!out) return false;
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+              fwrite(spectrum, sizeof(complex_t), (size_t)count, out) == (size_t)count &&
+              fwrite(epicycles, sizeof(epicycle_t), (size_t)count, out) == (size_t)count;
+    if (fclose(out) != 0) ok = false;
+
+    if (ok) ok = platform_replace_file(temp, path);
+    if (!ok) remove(temp);
+    return ok;
+}
@@ -0,0 +1,761 @@
+/**
+ * fft.c - Fast Fourier Transform Engine Implementation
+ */
+
+#include "fft.h"
+#include "platform.h"
+#include "task_pool.h"
+#include "mem.h"
+
+#define FFT_TWO_PI 6.283185307179586476925286766559
+
+typedef enum {
+    FFT_KIND_POW2,
+    FFT_KIND_MIXED,
+    FFT_KIND_BLUESTEIN
+} fft_kind_t;
+
+struct fft_plan {
+    int n;
+    fft_kind_t kind;
+    complex_t *twiddles;             /* W_N^j = e^(-2*pi*i*j/N), j = 0..N-1 */
+
+    /* Power-of-two path */
+    int *bitrev;                     /* Bit-reversal permutation of 0..N-1 */
+    int log2n;
+
+    /* Mixed-radix path: (radix, remaining length) pairs, outermost first */
+    int factors[2 * FFT_MAX_FACTORS];
+
+    /* Generic-radix butterflies and Bluestein convolution */
+    complex_t *scratch;
+
+    /* Bluestein path */
+    int m;                           /* Power-of-two convolution length >= 2N-1 */
+    complex_t *chirp;                /* e^(-i*pi*n^2/N), n = 0..N-1 */
+    complex_t *chirp_fft;            /* FFT of the wrapped, conjugated chirp */
+    struct fft_plan *sub;            /* Length-m plan used for the convolution */
+
+    /* Cache bookkeeping */
+    bool cached;                     /* Owned by the plan cache */
+    bool in_use;                     /* Currently handed out by fft_plan_acquire() */
+    unsigned long long last_used;    /* LRU stamp */
+};
+
+/* ========== Plan Cache State ========== */
+
+/* Guards everything below; plans themselves are only touched by their acquirer */
+static platform_mutex_t cache_lock = PLATFORM_MUTEX_INIT;
+static fft_plan_t *plan_cache[FFT_PLAN_CACHE_SIZE];
+static unsigned long long cache_clock;
+static fft_cache_stats_t cache_stats;
+
+/* ========== Small Helpers ========== */
+
+static complex_t cmul(complex_t a, complex_t b)
+{
+    complex_t r;
+    r.real = a.real * b.real - a.imag * b.imag;
+    r.imag = a.real * b.imag + a.imag * b.real;
+    return r;
+}
+
+static bool is_pow2(int n)
+{
+    return n > 0 && (n & (n - 1)) == 0;
+}
+
+static complex_t unit_phasor(double angle)
+{
+    complex_t r;
+    r.real = (float)cos(angle);
+    r.imag = (float)sin(angle);
+    return r;
+}
+
+/* Split n into radices 4, 2, 3, 5, 7, ... Returns false if a prime factor exceeds FFT_MAX_RADIX */
+static bool factorize(int n, int *factors)
+{
+    int p = 4;
+    int i = 0;
+
+    while (n > 1) {
+        while (n % p) {
+            switch (p) {
+                case 4:  p = 2; break;
+                case 2:  p = 3; break;
+                default: p += 2; break;
+            }
+            if (p > FFT_MAX_RADIX) return false;
+        }
+        n /= p;
+        factors[i++] = p;
+        factors[i++] = n;
+    }
+    return true;
+}
+
+/* ========== Plan Construction ========== */
+
+void fft_plan_destroy(fft_plan_t *plan)
+{
+    if (!plan) return;
+    mem_free(plan->twiddles);
+    mem_free(plan->bitrev);
+    mem_free(plan->scratch);
+    mem_free(plan->chirp);
+    mem_free(plan->chirp_fft);
+    fft_plan_destroy(plan->sub);
+    mem_free(plan);
+}
+
+fft_plan_t *fft_plan_create(int n)
+{
+    if (n <= 0) return NULL;
+
+    fft_plan_t *plan = (fft_plan_t *)mem_calloc(1, sizeof(fft_plan_t));
+    if (!plan) return NULL;
+    plan->n = n;
+
+    if (is_pow2(n)) {
+        plan->kind = FFT_KIND_POW2;
+    } else if (factorize(n, plan->factors)) {
+        plan->kind = FFT_KIND_MIXED;
+    } else {
+        plan->kind = FFT_KIND_BLUESTEIN;
+    }
+
+    if (plan->kind != FFT_KIND_BLUESTEIN) {
+        plan->twiddles = (complex_t *)mem_alloc(sizeof(complex_t) * n);
+        if (!plan->twiddles) { fft_plan_destroy(plan); return NULL; }
+        for (int j = 0; j < n; j++) {
+            plan->twiddles[j] = unit_phasor(-FFT_TWO_PI * j / n);
+        }
+    }
+
+    switch (plan->kind) {
+        case FFT_KIND_POW2: {
+            plan->bitrev = (int *)mem_alloc(sizeof(int) * n);
+            if (!plan->bitrev) { fft_plan_destroy(plan); return NULL; }
+            while ((1 << plan->log2n) < n) plan->log2n++;
+            for (int i = 0; i < n; i++) {
+                int r = 0;
+                for (int b = 0; b < plan->log2n; b++) {
+                    r |= ((i >> b) & 1) << (plan->log2n - 1 - b);
+                }
+                plan->bitrev[i] = r;
+            }
+            break;
+        }
+        case FFT_KIND_MIXED: {
+            plan->scratch = (complex_t *)mem_alloc(sizeof(complex_t) * FFT_MAX_RADIX);
+            if (!plan->scratch) { fft_plan_destroy(plan); return NULL; }
+            break;
+        }
+        case FFT_KIND_BLUESTEIN: {
+            plan->m = 1;
+            while (plan->m < 2 * n - 1) plan->m <<= 1;
+
+            plan->sub       = fft_plan_create(plan->m);
+            plan->chirp     = (complex_t *)mem_alloc(sizeof(complex_t) * n);
+            plan->chirp_fft = (complex_t *)mem_alloc(sizeof(complex_t) * plan->m);
+            plan->scratch   = (complex_t *)mem_alloc(sizeof(complex_t) * plan->m * 2);
+            if (!plan->sub || !plan->chirp || !plan->chirp_fft || !plan->scratch) {
+                fft_plan_destroy(plan);
+                return NULL;
+            }
+
+            /* n^2 is reduced mod 2N in integers so the angle stays accurate for large n */
+            for (int i = 0; i < n; i++) {
+                long long sq = ((long long)i * i) % (2LL * n);
+                plan->chirp[i] = unit_phasor(-FFT_TWO_PI * 0.5 * (double)sq / n);
+            }
+
+            /* b[j] = conj(chirp[|j|]) for -N < j < N, wrapped into length m */
+            complex_t *b = plan->scratch;
+            for (int j = 0; j < plan->m; j++) {
+                b[j].real = 0.0f;
+                b[j].imag = 0.0f;
+            }
+            for (int j = 0; j < n; j++) {
+                b[j].real =  plan->chirp[j].real;
+                b[j].imag = -plan->chirp[j].imag;
+                if (j > 0) b[plan->m - j] = b[j];
+            }
+            fft_execute(plan->sub, b, plan->chirp_fft);
+            break;
+        }
+    }
+    return plan;
+}
+
+/* ========== Power-of-Two Path ========== */
+
+/* Gather in bit-reversed order (the permutation is its own inverse) */
+static void pow2_permute(const fft_plan_t *plan, const complex_t *in, complex_t *out, int begin, int end)
+{
+    for (int i = begin; i < end; i++) {
+        out[i] = in[plan->bitrev[i]];
+    }
+}
+
+/* Leading radix-2 pass over elements begin..end-1 (even bounds) when log2(N) is odd */
+static void pow2_radix2_pass(complex_t *out, int begin, int end)
+{
+    for (int i = begin; i < end; i += 2) {
+        complex_t a = out[i];
+        complex_t b = out[i + 1];
+        out[i].real     = a.real + b.real;
+        out[i].imag     = a.imag + b.imag;
+        out[i + 1].real = a.real - b.real;
+        out[i + 1].imag = a.imag - b.imag;
+    }
+}
+
+/*
+ * One radix-4 pass combining length-len blocks, for butterflies
+ * begin..end-1 of N/4 (butterfly j is output k = j % len of group j / len).
+ * In bit-reversed order the four length-len blocks of each group hold the
+ * sub-spectra of samples 4n+0, 4n+2, 4n+1, 4n+3.
+ */
+static void pow2_radix4_pass(const fft_plan_t *plan, complex_t *out, int len, int begin, int end)
+{
+    const complex_t *tw = plan->twiddles;
+    int stride = plan->n / (4 * len);
+
+    for (int j = begin; j < end; ) {
+        int group = j / len;
+        int k = j - group * len;
+        int k_end = len - k < end - j ? len : k + (end - j);
+        complex_t *f = out + group * 4 * len;
+        j += k_end - k;
+
+        for (; k < k_end; k++) {
+            complex_t a = f[k];
+            complex_t b = cmul(f[k + 2 * len], tw[k * stride]);
+            complex_t c = cmul(f[k + len],     tw[2 * k * stride]);
+            complex_t d = cmul(f[k + 3 * len], tw[3 * k * stride]);
+
+            complex_t ac_sum  = { a.real + c.real, a.imag + c.imag };
+            complex_t ac_diff = { a.real - c.real, a.imag - c.imag };
+            complex_t bd_sum  = { b.real + d.real, b.imag + d.imag };
+            complex_t bd_diff = { b.real - d.real, b.imag - d.imag };
+
+            f[k].real           = ac_sum.real + bd_sum.real;
+            f[k].imag           = ac_sum.imag + bd_sum.imag;
+            f[k + 2 * len].real = ac_sum.real - bd_sum.real;
+            f[k + 2 * len].imag = ac_sum.imag - bd_sum.imag;
+
+            /* -i*(b-d) and +i*(b-d) */
+            f[k + len].real     = ac_diff.real + bd_diff.imag;
+            f[k + len].imag     = ac_diff.imag - bd_diff.real;
+            f[k + 3 * len].real = ac_diff.real - bd_diff.imag;
+            f[k + 3 * len].imag = ac_diff.imag + bd_diff.real;
+        }
+    }
+}
+
+/* First pass length whose groups are wider than `block` (N when none are) */
+static int pow2_wide_len(const fft_plan_t *plan, int block)
+{
+    int len = (plan->log2n & 1) ? 2 : 1;
+    while (len < plan->n && 4 * len <= block) len *= 4;
+    return len;
+}
+
+/*
+ * Permutation and every pass whose groups fit in [begin, end), a
+ * block-aligned range of `block` elements (block is a power of two).
+ * Passes from pow2_wide_len() on are left to the caller; block = N runs
+ * the whole transform.
+ */
+static void pow2_local(const fft_plan_t *plan, const complex_t *in, complex_t *out,
+                      int begin, int end, int block)
+{
+    pow2_permute(plan, in, out, begin, end);
+
+    int len = 1;
+    if (plan->log2n & 1) {
+        pow2_radix2_pass(out, begin, end);
+        len = 2;
+    }
+    for (; len < plan->n && 4 * len <= block; len *= 4) {
+        pow2_radix4_pass(plan, out, len, begin / 4, end / 4);
+    }
+}
+
+static void execute_pow2(const fft_plan_t *plan, const complex_t *in, complex_t *out)
+{
+    pow2_local(plan, in, out, 0, plan->n, plan->n);
+}
+
+/* ========== Mixed-Radix Path ========== */
+
+static void butterfly2(complex_t *f, const complex_t *tw, int fstride, int m, int k0, int k1)
+{
+    for (int k = k0; k < k1; k++) {
+        complex_t t = cmul(f[k + m], tw[k * fstride]);
+        f[k + m].real = f[k].real - t.real;
+        f[k + m].imag = f[k].imag - t.imag;
+        f[k].real += t.real;
+        f[k].imag += t.imag;
+    }
+}
+
+static void butterfly3(complex_t *f, const complex_t *tw, int fstride, int m, int k0, int k1)
+{
+    float epi3_imag = tw[fstride * m].imag;   /* Im(e^(-2*pi*i/3)) */
+
+    for (int k = k0; k < k1; k++) {
+        complex_t s1 = cmul(f[k + m],     tw[k * fstride]);
+        complex_t s2 = cmul(f[k + 2 * m], tw[2 * k * fstride]);
+        complex_t sum  = { s1.real + s2.real, s1.imag + s2.imag };
+        complex_t diff = { (s1.real - s2.real) * epi3_imag, (s1.imag - s2.imag) * epi3_imag };
+
+        complex_t mid = { f[k].real - 0.5f * sum.real, f[k].imag - 0.5f * sum.imag };
+        f[k].real += sum.real;
+        f[k].imag += sum.imag;
+
+        f[k + m].real     = mid.real - diff.imag;
+        f[k + m].imag     = mid.imag + diff.real;
+        f[k + 2 * m].real = mid.real + diff.imag;
+        f[k + 2 * m].imag = mid.imag - diff.real;
+    }
+}
+
+static void butterfly4(complex_t *f, const complex_t *tw, int fstride, int m, int k0, int k1)
+{
+    for (int k = k0; k < k1; k++) {
+        complex_t a = f[k];
+        complex_t b = cmul(f[k + m],     tw[k * fstride]);
+        complex_t c = cmul(f[k + 2 * m], tw[2 * k * fstride]);
+        complex_t d = cmul(f[k + 3 * m], tw[3 * k * fstride]);
+
+        complex_t ac_sum  = { a.real + c.real, a.imag + c.imag };
+        complex_t ac_diff = { a.real - c.real, a.imag - c.imag };
+        complex_t bd_sum  = { b.real + d.real, b.imag + d.imag };
+        complex_t bd_diff = { b.real - d.real, b.imag - d.imag };
+
+        f[k].real         = ac_sum.real + bd_sum.real;
+        f[k].imag         = ac_sum.imag + bd_sum.imag;
+        f[k + 2 * m].real = ac_sum.real - bd_sum.real;
+        f[k + 2 * m].imag = ac_sum.imag - bd_sum.imag;
+        f[k + m].real     = ac_diff.real + bd_diff.imag;
+        f[k + m].imag     = ac_diff.imag - bd_diff.real;
+        f[k + 3 * m].real = ac_diff.real - bd_diff.imag;
+        f[k + 3 * m].imag = ac_diff.imag + bd_diff.real;
+    }
+}
+
+static void butterfly5(complex_t *f, const complex_t *tw, int fstride, int m, int k0, int k1)
+{
+    complex_t ya = tw[fstride * m];        /* e^(-2*pi*i/5) */
+    complex_t yb = tw[fstride * 2 * m];    /* e^(-4*pi*i/5) */
+
+    for (int k = k0; k < k1; k++) {
+        complex_t s0 = f[k];
+        complex_t s1 = cmul(f[k + m],     tw[k * fstride]);
+        complex_t s2 = cmul(f[k + 2 * m], tw[2 * k * fstride]);
+        complex_t s3 = cmul(f[k + 3 * m], tw[3 * k * fstride]);
+        complex_t s4 = cmul(f[k + 4 * m], tw[4 * k * fstride]);
+
+        complex_t s7  = { s1.real + s4.real, s1.imag + s4.imag };
+        complex_t s10 = { s1.real - s4.real, s1.imag - s4.imag };
+        complex_t s8  = { s2.real + s3.real, s2.imag + s3.imag };
+        complex_t s9  = { s2.real - s3.real, s2.imag - s3.imag };
+
+        f[k].real = s0.real + s7.real + s8.real;
+        f[k].imag = s0.imag + s7.imag + s8.imag;
+
+        complex_t s5 = { s0.real + s7.real * ya.real + s8.real * yb.real,
+                         s0.imag + s7.imag * ya.real + s8.imag * yb.real };
+        complex_t s6 = {  s10.imag * ya.imag + s9.imag * yb.imag,
+                         -s10.real * ya.imag - s9.real * yb.imag };
+        f[k + m].real     = s5.real - s6.real;
+        f[k + m].imag     = s5.imag - s6.imag;
+        f[k + 4 * m].real = s5.real + s6.real;
+        f[k + 4 * m].imag = s5.imag + s6.imag;
+
+        complex_t s11 = { s0.real + s7.real * yb.real + s8.real * ya.real,
+                          s0.imag + s7.imag * yb.real + s8.imag * ya.real };
+        complex_t s12 = { -s10.imag * yb.imag + s9.imag * ya.imag,
+                           s10.real * yb.imag - s9.real * ya.imag };
+        f[k + 2 * m].real = s11.real + s12.real;
+        f[k + 2 * m].imag = s11.imag + s12.imag;
+        f[k + 3 * m].real = s11.real - s12.real;
+        f[k + 3 * m].imag = s11.imag - s12.imag;
+    }
+}
+
+/* Direct O(p^2) butterfly for the remaining small odd primes (7, 11, 13) */
+static void butterfly_generic(complex_t *f, const complex_t *tw, int fstride, int m, int k0, int k1,
+                              int p, int n, complex_t *scratch)
+{
+    for (int u = k0; u < k1; u++) {
+        for (int q = 0; q < p; q++) {
+            scratch[q] = f[u + q * m];
+        }
+        for (int q1 = 0; q1 < p; q1++) {
+            int k = u + q1 * m;
+            int twidx = 0;
+            complex_t acc = scratch[0];
+
+            for (int q = 1; q < p; q++) {
+                twidx += fstride * k;
+                if (twidx >= n) twidx -= n;
+                complex_t t = cmul(scratch[q], tw[twidx]);
+                acc.real += t.real;
+                acc.imag += t.imag;
+            }
+            f[k] = acc;
+        }
+    }
+}
+
+/* One radix-p combine pass over outputs k0..k1-1 of a length p*m block */
+static void mixed_butterfly(const fft_plan_t *plan, complex_t *out, int fstride, int p, int m,
+                            int k0, int k1, complex_t *scratch)
+{
+    switch (p) {
+        case 2:  butterfly2(out, plan->twiddles, fstride, m, k0, k1); break;
+        case 3:  butterfly3(out, plan->twiddles, fstride, m, k0, k1); break;
+        case 4:  butterfly4(out, plan->twiddles, fstride, m, k0, k1); break;
+        case 5:  butterfly5(out, plan->twiddles, fstride, m, k0, k1); break;
+        default: butterfly_generic(out, plan->twiddles, fstride, m, k0, k1, p, plan->n, scratch); break;
+    }
+}
+
+/* Decimation in time: transform the p interleaved sub-sequences, then combine with one radix-p pass */
+static void mixed_work(const fft_plan_t *plan, complex_t *out, const complex_t *in,
+                       int fstride, const int *factors, complex_t *scratch)
+{
+    int p = factors[0];
+    int m = factors[1];
+
+    if (m == 1) {
+        for (int q = 0; q < p; q++) {
+            out[q] = in[q * fstride];
+        }
+    } else {
+        for (int q = 0; q < p; q++) {
+            mixed_work(plan, out + q * m, in + q * fstride, fstride * p, factors + 2, scratch);
+        }
+    }
+
+    mixed_butterfly(plan, out, fstride, p, m, 0, m, scratch);
+}
+
+/* ========== Bluestein Path ========== */
+
+/*
+ * Using k*n = (k^2 + n^2 - (k-n)^2) / 2:
+ *   X[k] = chirp[k] * sum_n (x[n] * chirp[n]) * conj(chirp[k-n])
+ * which is a linear convolution, evaluated with length-m FFTs.
+ */
+static void execute_bluestein(const fft_plan_t *plan, const complex_t *in, complex_t *out)
+{
+    int n = plan->n;
+    int m = plan->m;
+    complex_t *a = plan->scratch;
+    complex_t *spec = plan->scratch + m;
+
+    for (int i = 0; i < n; i++) {
+        a[i] = cmul(in[i], plan->chirp[i]);
+    }
+    for (int i = n; i < m; i++) {
+        a[i].real = 0.0f;
+        a[i].imag = 0.0f;
+    }
+    fft_execute(plan->sub, a, spec);
+
+    /* Pointwise product, conjugated so the forward plan computes the inverse transform */
+    for (int i = 0; i < m; i++) {
+        complex_t c = cmul(spec[i], plan->chirp_fft[i]);
+        spec[i].real =  c.real;
+        spec[i].imag = -c.imag;
+    }
+    fft_execute(plan->sub, spec, a);
+
+    float inv_m = 1.0f / (float)m;
+    for (int k = 0; k < n; k++) {
+        complex_t c = { a[k].real * inv_m, -a[k].imag * inv_m };
+        out[k] = cmul(c, plan->chirp[k]);
+    }
+}
+
+/* ========== Parallel Execution ========== */
+
+/*
+ * Large transforms are split across the task pool. Every butterfly is
+ * computed exactly as on the serial path, from the same inputs, so the
+ * output is bit-identical to a single-threaded run; threads only change
+ * the order in which independent butterflies are visited.
+ */
+
+typedef struct {
+    const fft_plan_t *plan;
+    const complex_t *in;
+    complex_t *out;
+    int block;          /* Power of two: elements per independent block */
+    int len;            /* Power of two: current wide pass */
+    int depth;          /* Mixed radix: level being processed */
+    int fstride;        /* Mixed radix: input stride at that level */
+} fft_job_t;
+
+static volatile int parallel_min_n = FFT_PARALLEL_MIN_N;
+
+static void pow2_block_task(void *ctx, int begin, int end)
+{
+    const fft_job_t *job = (const fft_job_t *)ctx;
+    for (int b = begin; b < end; b++) {
+        pow2_local(job->plan, job->in, job->out, b * job->block, (b + 1) * job->block, job->block);
+    }
+}
+
+static void pow2_pass_task(void *ctx, int begin, int end)
+{
+    const fft_job_t *job = (const fft_job_t *)ctx;
+    pow2_radix4_pass(job->plan, job->out, job->len, begin, end);
+}
+
+/* Independent cache-sized blocks for the narrow passes, then each wide pass split by butterflies */
+static void execute_pow2_parallel(const fft_plan_t *plan, const complex_t *in, complex_t *out, int threads)
+{
+    int n = plan->n;
+    int block = FFT_PARALLEL_BLOCK < n ? FFT_PARALLEL_BLOCK : n;
+    while (block > 4 && n / block < 4 * threads) block >>= 1;
+
+    fft_job_t job = { plan, in, out, block, 0, 0, 0 };
+    task_pool_run(n / block, 1, pow2_block_task, &job);
+
+    for (job.len = pow2_wide_len(plan, block); job.len < n; job.len *= 4) {
+        task_pool_run(n / 4, FFT_PARALLEL_GRAIN, pow2_pass_task, &job);
+    }
+}
+
+/*
+ * Sub-transform `index` of the mixed-radix recursion at `depth`: offset of
+ * its output block and of its first input sample. The index is read as
+ * mixed-radix digits q_0..q_{depth-1} (q_0 most significant), the branch
+ * taken at each level.
+ */
+static void mixed_offsets(const int *factors, int depth, int index, int *out_offset, int *in_offset)
+{
+    int fstride = 1;
+    for (int d = 0; d < depth; d++) fstride *= factors[2 * d];
+
+    *out_offset = 0;
+    *in_offset = 0;
+    for (int d = depth - 1; d >= 0; d--) {
+        int p = factors[2 * d];
+        int q = index % p;
+        index /= p;
+        fstride /= p;
+        *out_offset += q * factors[2 * d + 1];
+        *in_offset += q * fstride;
+    }
+}
+
+static void mixed_subtransform_task(void *ctx, int begin, int end)
+{
+    const fft_job_t *job = (const fft_job_t *)ctx;
+    const int *factors = job->plan->factors;
+    complex_t scratch[FFT_MAX_RADIX];
+
+    for (int c = begin; c < end; c++) {
+        int out_offset, in_offset;
+        mixed_offsets(factors, job->depth, c, &out_offset, &in_offset);
+        mixed_work(job->plan, job->out + out_offset, job->in + in_offset, job->fstride,
+                   factors + 2 * job->depth, scratch);
+    }
+}
+
+/* Butterflies of one level, numbered block-major: item j is output j % m of block j / m */
+static void mixed_combine_task(void *ctx, int begin, int end)
+{
+    const fft_job_t *job = (const fft_job_t *)ctx;
+    const int *factors = job->plan->factors;
+    int p = factors[2 * job->depth];
+    int m = factors[2 * job->depth + 1];
+    complex_t scratch[FFT_MAX_RADIX];
+
+    for (int j = begin; j < end; ) {
+        int group = j / m;
+        int k = j - group * m;
+        int k_end = m - k < end - j ? m : k + (end - j);
+        int out_offset, in_offset;
+        mixed_offsets(factors, job->depth, group, &out_offset, &in_offset);
+        mixed_butterfly(job->plan, job->out + out_offset, job->fstride, p, m, k, k_end, scratch);
+        j += k_end - k;
+    }
+}
+
+/* Independent sub-transforms a few levels down, then the levels above combined level by level */
+static void execute_mixed_parallel(const fft_plan_t *plan, const complex_t *in, complex_t *out, int threads)
+{
+    const int *factors = plan->factors;
+    int depth = 0;
+    int subtransforms = 1;
+    while (factors[2 * depth + 1] > 1 && subtransforms < 4 * threads) {
+        subtransforms *= factors[2 * depth];
+        depth++;
+    }
+
+    fft_job_t job = { plan, in, out, 0, 0, depth, subtransforms };
+    task_pool_run(subtransforms, 1, mixed_subtransform_task, &job);
+
+    while (job.depth > 0) {
+        job.depth--;
+        job.fstride /= factors[2 * job.depth];
+        int items = job.fstride * factors[2 * job.depth + 1];
+        task_pool_run(items, FFT_PARALLEL_GRAIN, mixed_combine_task, &job);
+    }
+}
+
+void fft_set_parallel_threshold(int n)
+{
+    platform_atomic_store(&parallel_min_n, n);
+}
+
+int fft_parallel_threshold(void)
+{
+    return platform_atomic_load(&parallel_min_n);
+}
+
+/* ========== Execution ========== */
+
+int fft_plan_size(const fft_plan_t *plan)
+{
+    return plan ? plan->n : 0;
+}
+
+void fft_execute(const fft_plan_t *plan, const complex_t *in, complex_t *out)
+{
+    int min_n = fft_parallel_threshold();
+    int threads = (min_n > 0 && plan->n >= min_n) ? task_pool_threads() : 1;
+
+    if (threads > 1 && plan->kind == FFT_KIND_POW2) {
+        execute_pow2_parallel(plan, in, out, threads);
+        return;
+    }
+    if (threads > 1 && plan->kind == FFT_KIND_MIXED) {
+        execute_mixed_parallel(plan, in, out, threads);
+        return;
+    }
+
+    /* Bluestein: the two length-m convolution transforms go parallel on their own */
+    switch (plan->kind) {
+        case FFT_KIND_POW2:      execute_pow2(plan, in, out); break;
+        case FFT_KIND_MIXED:     mixed_work(plan, out, in, 1, plan->factors, plan->scratch); break;
+        case FFT_KIND_BLUESTEIN: execute_bluestein(plan, in, out); break;
+    }
+}
+
+/* ========== Plan Cache ========== */
+
+fft_plan_t *fft_plan_acquire(int n)
+{
+    if (n <= 0) return NULL;
+
+    platform_mutex_lock(&cache_lock);
+    for (int i = 0; i < FFT_PLAN_CACHE_SIZE; i++) {
+        fft_plan_t *plan = plan_cache[i];
+        if (plan && plan->n == n && !plan->in_use) {
+            plan->in_use = true;
+            plan->last_used = ++cache_clock;
+            cache_stats.hits++;
+            platform_mutex_unlock(&cache_lock);
+            return plan;
+        }
+    }
+    cache_stats.misses++;
+    platform_mutex_unlock(&cache_lock);
+
+    /* Build outside the lock; other threads keep using the cache meanwhile */
+    fft_plan_t *plan = fft_plan_create(n);
+    if (!plan) return NULL;
+    plan->in_use = true;
+
+    platform_mutex_lock(&cache_lock);
+
+    /*
+     * Take a free slot or evict the least recently used idle plan. If every
+     * slot is busy, hand out an uncached plan that is freed on release.
+     */
+    int slot = -1;
+    for (int i = 0; i < FFT_PLAN_CACHE_SIZE; i++) {
+        if (!plan_cache[i]) { slot = i; break; }
+        if (!plan_cache[i]->in_use && (slot < 0 || plan_cache[i]->last_used < plan_cache[slot]->last_used)) {
+            slot = i;
+        }
+    }
+
+    if (slot >= 0) {
+        if (plan_cache[slot]) {
+            fft_plan_destroy(plan_cache[slot]);
+            cache_stats.evictions++;
+            cache_stats.cached_plans--;
+        }
+        plan->cached = true;
+        plan->last_used = ++cache_clock;
+        plan_cache[slot] = plan;
+        cache_stats.cached_plans++;
+    }
+    platform_mutex_unlock(&cache_lock);
+    return plan;
+}
+
+void fft_plan_release(fft_plan_t *plan)
+{
+    if (!plan) return;
+    if (plan->cached) {
+        platform_mutex_lock(&cache_lock);
+        plan->in_use = false;
+        platform_mutex_unlock(&cache_lock);
+    } else {
+        fft_plan_destroy(plan);
+    }
+}
+
+fft_cache_stats_t fft_cache_stats(void)
+{
+    platform_mutex_lock(&cache_lock);
+    fft_cache_stats_t stats = cache_stats;
+    platform_mutex_unlock(&cache_lock);
+    return stats;
+}
+
+void fft_cache_clear(void)
+{
+    int kept = 0;
+
+    platform_mutex_lock(&cache_lock);
+    for (int i = 0; i < FFT_PLAN_CACHE_SIZE; i++) {
+        if (!plan_cache[i]) continue;
+        if (plan_cache[i]->in_use) {
+            kept++;
+            continue;
+        }
+        fft_plan_destroy(plan_cache[i]);
+        plan_cache[i] = NULL;
+    }
+    cache_stats.hits = 0;
+    cache_stats.misses = 0;
+    cache_stats.evictions = 0;
+    cache_stats.cached_plans = kept;
+    platform_mutex_unlock(&cache_lock);
+}
+
+/* ========== One-Shot Transform ========== */
+
+bool fft_forward(const complex_t *in, complex_t *out, int n)
+{
+    if (in == NULL || out == NULL || n <= 0 || in == out) return false;
+
+    fft_plan_t *plan = fft_plan_acquire(n);
+    if (!plan) return false;
+
+    fft_execute(plan, in, out);
+    fft_plan_release(plan);
+    return true;
+}
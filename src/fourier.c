@@ -1,4 +1,10 @@
 #include "fourier.h"
+#include "fcoef.h"
+#include "fft.h"
+#include "mem.h"
+#include "platform.h"
+#include "simd.h"
+#include <string.h>
 #include <stdbool.h>
 
 complex_t complex_add(complex_t *a, complex_t *b)
@@ -27,51 +33,93 @@ float complex_phase(complex_t *a)
     return atan2f(a->imag, a->real);
 }
 
-complex_t *DFT(complex_t *arr, int N)
+bool dft_into(const complex_t *in, complex_t *out, int N)
 {
-    if (arr == NULL) return NULL;
-
-    complex_t *output = (complex_t *)malloc(sizeof(complex_t) * N);
+    if (in == NULL || out == NULL || N <= 0) return false;
+    if (!fft_forward(in, out, N)) return false;
 
-    for (int k = 0; k < N; k++) 
+    /* Normalize by dividing by N to get proper amplitudes */
+    for (int k = 0; k < N; k++)
     {
-        output[k].real = 0;
-        output[k].imag = 0;
+        out[k].real /= N;
+        out[k].imag /= N;
+    }
+    return true;
+}
 
-        for (int n = 0; n < N; n++)
-        {
-            float angle = (-2 * PI * k * n) / N;
-            
-            complex_t rotation_factor; 
-            rotation_factor.real =  cosf(angle);
-            rotation_factor.imag =  sinf(angle);
+complex_t *DFT(complex_t *arr, int N)
+{
+    if (arr == NULL || N <= 0) return NULL;
 
-            /* (a + bi)(cos + i·sin) = (a·cos - b·sin) + i(a·sin + b·cos) */
-            output[k].real += arr[n].real * rotation_factor.real - arr[n].imag * rotation_factor.imag;
-            output[k].imag += arr[n].real * rotation_factor.imag + arr[n].imag * rotation_factor.real;
-        }
-        /* Normalize by dividing by N to get proper amplitudes */
-        output[k].real /= N;
-        output[k].imag /= N;
+    complex_t *output = (complex_t *)mem_alloc(sizeof(complex_t) * N);
+    if (!output) return NULL;
+
+    if (!dft_into(arr, output, N)) {
+        mem_free(output);
+        return NULL;
     }
     return output;
 }
 
-epicycle_t *dft_to_epicycles(complex_t *dft, int N)
+/* DC first, then by descending amplitude (frequency breaks ties so the order is stable) */
+static int compare_epicycles(const void *pa, const void *pb)
 {
-    if (dft == NULL) return NULL;
+    const epicycle_t *a = (const epicycle_t *)pa;
+    const epicycle_t *b = (const epicycle_t *)pb;
 
-    epicycle_t *epic = (epicycle_t *)malloc(sizeof(epicycle_t) * N);
+    if ((a->frequency == 0.0f) != (b->frequency == 0.0f)) return a->frequency == 0.0f ? -1 : 1;
+    if (a->amplitude != b->amplitude) return a->amplitude > b->amplitude ? -1 : 1;
+    if (a->frequency != b->frequency) return a->frequency < b->frequency ? -1 : 1;
+    return 0;
+}
 
+void dft_to_epicycles_into(const complex_t *dft, epicycle_t *out, int N, bool centered)
+{
     for (int k = 0; k < N; k++) 
     {
-        epic[k].frequency = (float)k;
-        epic[k].amplitude = complex_magnitude(&dft[k]);
-        epic[k].phase     = complex_phase(&dft[k]);
+        complex_t bin = dft[k];
+        out[k].frequency = (float)((centered && k > N / 2) ? k - N : k);
+        out[k].amplitude = complex_magnitude(&bin);
+        out[k].phase     = complex_phase(&bin);
     }
+
+    /* Largest circles first, so a prefix of the array is the best K-term approximation */
+    qsort(out, (size_t)N, sizeof(epicycle_t), compare_epicycles);
+}
+
+epicycle_t *dft_to_epicycles(complex_t *dft, int N, bool centered)
+{
+    if (dft == NULL || N <= 0) return NULL;
+
+    epicycle_t *epic = (epicycle_t *)mem_alloc(sizeof(epicycle_t) * N);
+    if (!epic) return NULL;
+
+    dft_to_epicycles_into(dft, epic, N, centered);
     return epic;
 }
 
+int epicycles_terms_for_energy(const epicycle_t *epic, int N, float fraction)
+{
+    if (epic == NULL || N <= 0) return 0;
+    if (fraction >= 1.0f) return N;
+
+    double total = 0.0;
+    for (int k = 0; k < N; k++)
+    {
+        if (epic[k].frequency != 0.0f) total += (double)epic[k].amplitude * epic[k].amplitude;
+    }
+
+    double target = total * fraction;
+    double kept = 0.0;
+    int count = 0;
+    while (count < N && (kept < target || epic[count].frequency == 0.0f))
+    {
+        if (epic[count].frequency != 0.0f) kept += (double)epic[count].amplitude * epic[count].amplitude;
+        count++;
+    }
+    return count > 0 ? count : 1;
+}
+
 Vector2 epicycles_position(epicycle_t *epic, int N, float t)
 {
     Vector2 sum = { 0, 0 };
@@ -86,51 +134,427 @@ Vector2 epicycles_position(epicycle_t *epic, int N, float t)
     return sum;
 }
 
-Vector2 draw_epicycles(epicycle_t *epic, int N, float t, float line_thickness)
+/* ========== Incremental Evaluator ========== */
+
+void epicycle_eval_init(epicycle_eval_t *ev)
+{
+    ev->count = 0;
+    ev->capacity = 0;
+    ev->step = 0;
+    ev->steps_since_renorm = 0;
+    ev->steps_since_seed = 0;
+    ev->dt = 0.0f;
+    ev->amplitude = NULL;
+    ev->arm_x = NULL;
+    ev->arm_y = NULL;
+    ev->rot_x = NULL;
+    ev->rot_y = NULL;
+    ev->epic = NULL;
+}
+
+bool epicycle_eval_setup(epicycle_eval_t *ev, const epicycle_t *epic, int N, float dt)
 {
-    float x = 0;
-    float y = 0;
+    if (epic == NULL || N <= 0) return false;
+
+    if (N > ev->capacity) {
+        /* One block holds all five per-term arrays */
+        float *block = (float *)mem_alloc(sizeof(float) * 5 * (size_t)N);
+        if (!block) return false;
+        mem_free(ev->amplitude);
+        ev->amplitude = block;
+        ev->arm_x     = block + N;
+        ev->arm_y     = block + 2 * N;
+        ev->rot_x     = block + 3 * N;
+        ev->rot_y     = block + 4 * N;
+        ev->capacity  = N;
+    }
+
+    ev->count = N;
+    ev->dt = dt;
+    ev->epic = epic;
 
     for (int k = 0; k < N; k++)
     {
-        float prev_x = x;
-        float prev_y = y;
-        
-        float phase_arg = epic[k].frequency * t + epic[k].phase;
-        x += epic[k].amplitude * cosf(phase_arg);
-        y += epic[k].amplitude * sinf(phase_arg);
-        
-        /* Only draw circles if amplitude is significant enough to see */
-        if (epic[k].amplitude > 1.0f) {
-            /* Color gradient based on index */
-            unsigned char r = (unsigned char)(50 + ((k * 205) % 206));
-            unsigned char g = (unsigned char)(100 + ((k * 50) % 156));
-            unsigned char b = (unsigned char)(200 - ((k * 100) % 151));
-            
-            /* Draw the circle for this epicycle */
-            DrawCircleLines((int)prev_x, (int)prev_y, epic[k].amplitude, (Color){r, g, b, 80});
-            
-            /* Draw line from center to point on circle (the arm) */
-            DrawLineEx((Vector2){prev_x, prev_y}, (Vector2){x, y}, line_thickness, (Color){r, g, b, 180});
+        double step_angle = (double)epic[k].frequency * dt;
+        ev->amplitude[k] = epic[k].amplitude;
+        ev->rot_x[k] = (float)cos(step_angle);
+        ev->rot_y[k] = (float)sin(step_angle);
+    }
+
+    epicycle_eval_seed(ev, 0);
+    return true;
+}
+
+void epicycle_eval_seed(epicycle_eval_t *ev, int step)
+{
+    double t = (double)step * ev->dt;
+
+    for (int k = 0; k < ev->count; k++)
+    {
+        double phase_arg = (double)ev->epic[k].frequency * t + ev->epic[k].phase;
+        ev->arm_x[k] = ev->amplitude[k] * (float)cos(phase_arg);
+        ev->arm_y[k] = ev->amplitude[k] * (float)sin(phase_arg);
+    }
+    ev->step = step;
+    ev->steps_since_renorm = 0;
+    ev->steps_since_seed = 0;
+}
+
+void epicycle_eval_step(epicycle_eval_t *ev)
+{
+    /* Rounding in the rotation angle accumulates as phase drift; start over from exact values */
+    if (++ev->steps_since_seed >= EVAL_RESEED_INTERVAL) {
+        epicycle_eval_seed(ev, ev->step + 1);
+        return;
+    }
+
+    for (int k = 0; k < ev->count; k++)
+    {
+        /* arm *= e^(i*frequency*dt) */
+        float x = ev->arm_x[k];
+        float y = ev->arm_y[k];
+        ev->arm_x[k] = x * ev->rot_x[k] - y * ev->rot_y[k];
+        ev->arm_y[k] = x * ev->rot_y[k] + y * ev->rot_x[k];
+    }
+    ev->step++;
+
+    /* Pull each arm back onto its circle so magnitude errors cannot compound */
+    if (++ev->steps_since_renorm >= EVAL_RENORM_INTERVAL) {
+        for (int k = 0; k < ev->count; k++)
+        {
+            float len = sqrtf(ev->arm_x[k] * ev->arm_x[k] + ev->arm_y[k] * ev->arm_y[k]);
+            if (len > 0.0f) {
+                float s = ev->amplitude[k] / len;
+                ev->arm_x[k] *= s;
+                ev->arm_y[k] *= s;
+            }
         }
+        ev->steps_since_renorm = 0;
     }
-    
-    /* Draw final tip position - THIS is where the line is drawn from */
-    DrawCircle((int)x, (int)y, 4.0f * line_thickness, (Color){255, 100, 100, 255});
-    
-    return (Vector2){ x, y };
 }
+
+void epicycle_eval_sync(epicycle_eval_t *ev, float t)
+{
+    if (ev->count <= 0 || ev->dt <= 0.0f) return;
+
+    int target = (int)lroundf(t / ev->dt);
+    if (target == ev->step) return;
+
+    if (target == ev->step + 1) {
+        epicycle_eval_step(ev);
+    } else {
+        epicycle_eval_seed(ev, target);
+    }
+}
+
+Vector2 epicycle_eval_position(const epicycle_eval_t *ev)
+{
+    Vector2 sum = { 0, 0 };
+
+    for (int k = 0; k < ev->count; k++)
+    {
+        sum.x += ev->arm_x[k];
+        sum.y += ev->arm_y[k];
+    }
+    return sum;
+}
+
+void epicycle_eval_free(epicycle_eval_t *ev)
+{
+    mem_free(ev->amplitude);
+    epicycle_eval_init(ev);
+}
+
+/* ========== Online Transform ========== */
+
+void online_dft_init(online_dft_t *od)
+{
+    od->count = 0;
+    od->size = 0;
+    od->capacity = 0;
+    od->acc = NULL;
+    od->twiddles = NULL;
+    od->regrows = 0;
+}
+
+/* Smallest n >= target whose prime factors are 2, 3 and 5 (fast FFT sizes) */
+static int next_smooth_size(int target)
+{
+    for (int n = target; ; n++) {
+        int m = n;
+        while (m % 2 == 0) m /= 2;
+        while (m % 3 == 0) m /= 3;
+        while (m % 5 == 0) m /= 5;
+        if (m == 1) return n;
+    }
+}
+
+/* Move to a grid of at least `target` samples and rebuild A from the first count points */
+static bool online_dft_regrow(online_dft_t *od, const point_list_t *points, int count, int target)
+{
+    int size = next_smooth_size(target < ONLINE_DFT_MIN_SIZE ? ONLINE_DFT_MIN_SIZE : target);
+
+    if (size > od->capacity) {
+        int capacity = od->capacity;
+        if (!mem_reserve((void **)&od->acc, &capacity, size, sizeof(complex_d_t))) return false;
+        capacity = od->capacity;
+        if (!mem_reserve((void **)&od->twiddles, &capacity, size, sizeof(complex_d_t))) return false;
+        od->capacity = capacity;
+    }
+
+    fft_plan_t *plan = fft_plan_create(size);
+    complex_t *in = (complex_t *)mem_calloc((size_t)size, sizeof(complex_t));
+    complex_t *out = (complex_t *)mem_alloc(sizeof(complex_t) * size);
+    bool ok = plan && in && out;
+    if (ok) {
+        /* Zero-padded points: the FFT gives A for the new grid directly */
+        for (int n = 0; n < count; n++) {
+            in[n].real = points->data[n].x;
+            in[n].imag = points->data[n].y;
+        }
+        fft_execute(plan, in, out);
+
+        for (int k = 0; k < size; k++) {
+            od->acc[k].real = out[k].real;
+            od->acc[k].imag = out[k].imag;
+            double angle = -2.0 * PI * k / size;
+            od->twiddles[k].real = cos(angle);
+            od->twiddles[k].imag = sin(angle);
+        }
+        od->size = size;
+        od->count = count;
+        od->regrows++;
+    }
+
+    /* One-off sizes: a private plan keeps them out of the shared plan cache */
+    fft_plan_destroy(plan);
+    mem_free(in);
+    mem_free(out);
+    return ok;
+}
+
+bool online_dft_update(online_dft_t *od, const point_list_t *points)
+{
+    if (points->count < od->count) online_dft_reset(od);
+    if (points->count == od->count) return true;
+
+    /* Grid full: regrow with every point so far in one FFT */
+    if (points->count > od->size) {
+        int n = points->count;
+        if (!online_dft_regrow(od, points, n, n + n / ONLINE_DFT_GROWTH)) {
+            online_dft_reset(od);
+            return false;
+        }
+        return true;
+    }
+
+    int size = od->size;
+    for (int n = od->count; n < points->count; n++) {
+        /* A[k] += x[n] * W^(k*n), walking the twiddle index by n mod L */
+        double x = points->data[n].x;
+        double y = points->data[n].y;
+        int step = n % size;
+        int idx = 0;
+        for (int k = 0; k < size; k++) {
+            complex_d_t w = od->twiddles[idx];
+            od->acc[k].real += x * w.real - y * w.imag;
+            od->acc[k].imag += x * w.imag + y * w.real;
+            idx += step;
+            if (idx >= size) idx -= size;
+        }
+    }
+    od->count = points->count;
+    return true;
+}
+
+void online_dft_spectrum(const online_dft_t *od, const point_list_t *points, complex_t *out)
+{
+    int n = od->count;
+    int size = od->size;
+    int spare = size - n;
+
+    /*
+     * Closing samples j = 0..spare-1 sit at grid index n + j with value
+     * p + q * (j + 1), a straight line from x[n-1] toward x[0]. Their sum
+     * against W^(k*(n+j)) is W^(k*n) * (p * S0 + q * S1), where for
+     * z = W^k != 1
+     *   S0 = sum z^j         = (1 - z^M) / (1 - z)
+     *   S1 = sum (j+1) z^j   = (1 - (M+1) z^M + M z^(M+1)) / (1 - z)^2
+     * with M = spare (and S0 = M, S1 = M(M+1)/2 at z = 1).
+     */
+    Vector2 first = points->data[0];
+    Vector2 last = points->data[n - 1];
+    complex_d_t p = { last.x, last.y };
+    complex_d_t q = { (first.x - last.x) / (spare + 1.0), (first.y - last.y) / (spare + 1.0) };
+    double inv_size = 1.0 / size;
+
+    /* Twiddle indices k*M, k*(M+1) and k*n mod L, advanced per bin */
+    int idx_m = 0;
+    int idx_m1 = 0;
+    int idx_n = 0;
+
+    for (int k = 0; k < size; k++) {
+        complex_d_t acc = od->acc[k];
+
+        if (spare > 0) {
+            complex_d_t s0, s1;
+            if (k == 0) {
+                s0.real = spare;
+                s0.imag = 0.0;
+                s1.real = 0.5 * spare * (spare + 1.0);
+                s1.imag = 0.0;
+            } else {
+                complex_d_t z = od->twiddles[k];
+                complex_d_t zm = od->twiddles[idx_m];
+                complex_d_t zm1 = od->twiddles[idx_m1];
+
+                /* 1 / (1 - z) */
+                double dr = 1.0 - z.real;
+                double di = -z.imag;
+                double den = dr * dr + di * di;
+                complex_d_t inv = { dr / den, -di / den };
+
+                complex_d_t a0 = { 1.0 - zm.real, -zm.imag };
+                s0.real = a0.real * inv.real - a0.imag * inv.imag;
+                s0.imag = a0.real * inv.imag + a0.imag * inv.real;
+
+                complex_d_t a1 = { 1.0 - (spare + 1.0) * zm.real + spare * zm1.real,
+                                   -(spare + 1.0) * zm.imag + spare * zm1.imag };
+                complex_d_t inv2 = { inv.real * inv.real - inv.imag * inv.imag, 2.0 * inv.real * inv.imag };
+                s1.real = a1.real * inv2.real - a1.imag * inv2.imag;
+                s1.imag = a1.real * inv2.imag + a1.imag * inv2.real;
+            }
+
+            complex_d_t sum = { p.real * s0.real - p.imag * s0.imag + q.real * s1.real - q.imag * s1.imag,
+                                p.real * s0.imag + p.imag * s0.real + q.real * s1.imag + q.imag * s1.real };
+            complex_d_t w = od->twiddles[idx_n];
+            acc.real += sum.real * w.real - sum.imag * w.imag;
+            acc.imag += sum.real * w.imag + sum.imag * w.real;
+        }
+
+        idx_m += spare;
+        if (idx_m >= size) idx_m -= size;
+        idx_m1 += spare + 1;
+        if (idx_m1 >= size) idx_m1 -= size;
+        idx_n += n;
+        if (idx_n >= size) idx_n -= size;
+
+        out[k].real = (float)(acc.real * inv_size);
+        out[k].imag = (float)(acc.imag * inv_size);
+    }
+}
+
+void online_dft_reset(online_dft_t *od)
+{
+    od->count = 0;
+    od->size = 0;
+    od->regrows = 0;
+}
+
+void online_dft_free(online_dft_t *od)
+{
+    mem_free(od->acc);
+    mem_free(od->twiddles);
+    online_dft_init(od);
+}
+
+/* ========== Resampling ========== */
+
+int resample_target(resample_mode_t mode, int n, int fixed)
+{
+    int m;
+    if (mode == RESAMPLE_POW2) {
+        /* Nearest power of two: round log2(n), i.e. compare against the geometric midpoint */
+        m = 1;
+        while (m < RESAMPLE_MAX_POINTS && (double)m * m * 2.0 < (double)n * n) m *= 2;
+    } else if (mode == RESAMPLE_FIXED) {
+        m = fixed;
+    } else {
+        return 0;
+    }
+    if (n <= 0) return 0;
+    if (m < RESAMPLE_MIN_POINTS) m = RESAMPLE_MIN_POINTS;
+    if (m > RESAMPLE_MAX_POINTS) m = RESAMPLE_MAX_POINTS;
+    return m;
+}
+
+/* ========== Step Clock ========== */
+
+void step_clock_init(step_clock_t *clock, float step_time, int max_steps)
+{
+    clock->step_time = step_time;
+    clock->max_steps = max_steps > 0 ? max_steps : 1;
+    step_clock_reset(clock);
+}
+
+void step_clock_reset(step_clock_t *clock)
+{
+    clock->accumulator = 0.0f;
+    clock->last_steps = 0;
+    clock->stalls = 0;
+}
+
+int step_clock_advance(step_clock_t *clock, float elapsed)
+{
+    if (elapsed > 0.0f) clock->accumulator += elapsed;
+
+    /* The tolerance keeps float rounding from leaving a whole step pending */
+    int steps = (int)(clock->accumulator / clock->step_time + 1e-3f);
+    if (steps > clock->max_steps) {
+        /* Too far behind to catch up smoothly: keep the phase, drop the backlog */
+        clock->accumulator = fmodf(clock->accumulator, clock->step_time);
+        steps = clock->max_steps;
+        clock->stalls++;
+    } else {
+        clock->accumulator -= steps * clock->step_time;
+    }
+    if (clock->accumulator < 0.0f) clock->accumulator = 0.0f;
+
+    clock->last_steps = steps;
+    return steps;
+}
+
+float step_clock_alpha(const step_clock_t *clock)
+{
+    float alpha = clock->accumulator / clock->step_time;
+    return alpha < 1.0f ? alpha : 1.0f;
+}
+
 /* ========== Application State Functions ========== */
 
 void app_state_init(AppState *state) {
-    state->point_count = 0;
-    state->trace_count = 0;
+    mem_arena_init(&state->arena, 0);
+    point_list_init(&state->drawing_points, &state->arena);
+    point_list_init(&state->trace_points, &state->arena);
+    state->dft_input = NULL;
     state->dft_result = NULL;
     state->epicycles = NULL;
+    state->dft_input_capacity = 0;
+    state->dft_result_capacity = 0;
+    state->epicycles_capacity = 0;
+    state->spectrum_size = 0;
+    state->total_steps = 0;
+    state->preview = false;
+    epicycle_eval_init(&state->eval);
+    epicycle_soa_init(&state->soa);
+    state->energy_fraction = DEFAULT_ENERGY_FRACTION;
+    state->centered_freqs = true;
+    state->active_terms = 0;
+    state->last_start_allocs = 0;
+    state->resample_mode = RESAMPLE_OFF;
+    state->resample_points = DEFAULT_RESAMPLE_POINTS;
+    point_list_init(&state->resample_scratch, &state->arena);
+    online_dft_init(&state->online);
+    state->online_transform = true;
+    state->coef_cache_dir = NULL;
+    state->cache_key = 0;
+    state->transform = NULL;
+    state->retired_transforms = NULL;
+    state->spare_transform = NULL;
     
     state->t = 0.0f;
     state->speed = 1.0f;
-    state->frame_time = 0.0f;
+    step_clock_init(&state->clock, ANIMATION_STEP_TIME, ANIMATION_MAX_STEPS);
     state->line_thickness = 2.0f;
     state->current_k = 0;
     state->color_index = 0;
@@ -146,51 +570,530 @@ void app_state_init(AppState *state) {
     state->file_scroll = 0;
 }
 
+/* Copy the drawing into the transform input buffer */
+static void fill_dft_input(const point_list_t *points, complex_t *input) {
+    for (int i = 0; i < points->count; i++) {
+        input[i].real = points->data[i].x;
+        input[i].imag = points->data[i].y;
+    }
+}
+
+/* Spectrum, sorted epicycles and term budget of n input samples */
+static bool transform_input(const complex_t *input, complex_t *result, epicycle_t *epicycles, int n,
+                            bool centered, float fraction, int *active_terms) {
+    if (!dft_into(input, result, n)) return false;
+    dft_to_epicycles_into(result, epicycles, n, centered);
+    *active_terms = epicycles_terms_for_energy(epicycles, n, fraction);
+    return true;
+}
+
+/*
+ * Bind the evaluators to the state's n-term spectrum and start the run from
+ * t = 0 with `steps` trace steps per cycle (n itself, or the full input
+ * size when the spectrum is a decimated preview).
+ */
+static bool begin_animation(AppState *state, int n, int steps, int active_terms) {
+    state->spectrum_size = n;
+    state->total_steps = steps;
+    
+    /* Only the top-K terms are evaluated; t advances by a fixed 2*pi/steps per trace step */
+    state->active_terms = active_terms;
+    if (!epicycle_eval_setup(&state->eval, state->epicycles, state->active_terms, (2 * PI) / steps)) return false;
+    if (!epicycle_soa_load(&state->soa, state->epicycles, state->active_terms)) return false;
+    
+    /* Reset animation state; the trace gets one point per step, steps + 1 at most */
+    state->t = 0.0f;
+    step_clock_reset(&state->clock);
+    point_list_clear(&state->trace_points);
+    if (!point_list_reserve(&state->trace_points, steps + 1)) return false;
+    state->animation_done = false;
+    state->proceed = true;
+    return true;
+}
+
+bool app_resample_input(AppState *state) {
+    int n = state->drawing_points.count;
+    int m = resample_target(state->resample_mode, n, state->resample_points);
+    if (m <= 0 || !point_list_resample(&state->drawing_points, &state->resample_scratch, m)) return false;
+    
+    point_list_t resampled = state->resample_scratch;
+    state->resample_scratch = state->drawing_points;
+    state->drawing_points = resampled;
+    return true;
+}
+
 bool app_start_animation(AppState *state) {
-    if (state->point_count <= 0) return false;
+    int n = state->drawing_points.count;
+    uint64_t cache_key = state->cache_key;
+    state->cache_key = 0;
+    if (n <= 0) return false;
+    
+    mem_stats_t before = mem_stats();
+    app_cancel_transform(state);
+    state->spectrum_size = 0;
+    state->eval.count = 0;
+    
+    /* Grow the reusable buffers only when this N is larger than any before */
+    if (!mem_reserve((void **)&state->dft_input, &state->dft_input_capacity, n, sizeof(complex_t)) ||
+        !mem_reserve((void **)&state->dft_result, &state->dft_result_capacity, n, sizeof(complex_t)) ||
+        !mem_reserve((void **)&state->epicycles, &state->epicycles_capacity, n, sizeof(epicycle_t))) {
+        return false;
+    }
+    
+    fill_dft_input(&state->drawing_points, state->dft_input);
+    
+    int active_terms;
+    if (!transform_input(state->dft_input, state->dft_result, state->epicycles, n,
+                         state->centered_freqs, state->energy_fraction, &active_terms)) {
+        return false;
+    }
+    state->preview = false;
+    if (!begin_animation(state, n, n, active_terms)) return false;
     
-    /* Free any existing data */
-    if (state->dft_result) { free(state->dft_result); state->dft_result = NULL; }
-    if (state->epicycles)  { free(state->epicycles);  state->epicycles = NULL; }
+    mem_stats_t after = mem_stats();
+    state->last_start_allocs = (after.allocs - before.allocs) + (after.reallocs - before.reallocs);
     
-    /* Allocate and populate complex array from drawing points */
-    state->dft_result = (complex_t *)malloc(sizeof(complex_t) * state->point_count);
-    if (!state->dft_result) return false;
+    /* After the count: the cache write is file I/O, not pipeline allocations */
+    if (cache_key && state->coef_cache_dir) {
+        fcoef_store(state->coef_cache_dir, cache_key, state->dft_result, state->epicycles, n, state->centered_freqs);
+    }
+    return true;
+}
+
+bool app_start_animation_cached(AppState *state) {
+    int n = state->drawing_points.count;
+    state->cache_key = 0;
+    if (!state->coef_cache_dir || n < FCOEF_MIN_POINTS) return false;
     
-    for (int i = 0; i < state->point_count; i++) {
-        state->dft_result[i].real = state->drawing_points[i].x;
-        state->dft_result[i].imag = state->drawing_points[i].y;
+    mem_stats_t before = mem_stats();
+    uint64_t key = fcoef_key(&state->drawing_points);
+    fcoef_file_t file;
+    if (!fcoef_open(state->coef_cache_dir, key, n, &file)) {
+        state->cache_key = key;
+        return false;
     }
     
-    /* Compute DFT */
-    state->dft_result = DFT(state->dft_result, state->point_count);
-    if (!state->dft_result) return false;
+    app_cancel_transform(state);
+    state->spectrum_size = 0;
+    state->eval.count = 0;
+    if (!mem_reserve((void **)&state->dft_result, &state->dft_result_capacity, n, sizeof(complex_t)) ||
+        !mem_reserve((void **)&state->epicycles, &state->epicycles_capacity, n, sizeof(epicycle_t))) {
+        fcoef_close(&file);
+        return false;
+    }
     
-    /* Convert to epicycles */
-    state->epicycles = dft_to_epicycles(state->dft_result, state->point_count);
-    if (!state->epicycles) return false;
+    /* The spectrum is always kept; the epicycles are re-sorted only if the frequency mode differs */
+    memcpy(state->dft_result, file.spectrum, sizeof(complex_t) * (size_t)n);
+    if (file.centered == state->centered_freqs) {
+        memcpy(state->epicycles, file.epicycles, sizeof(epicycle_t) * (size_t)n);
+    } else {
+        dft_to_epicycles_into(state->dft_result, state->epicycles, n, state->centered_freqs);
+    }
+    fcoef_close(&file);
     
-    /* Reset animation state */
-    state->t = 0.0f;
-    state->trace_count = 0;
-    state->animation_done = false;
-    state->proceed = true;
+    int active_terms = epicycles_terms_for_energy(state->epicycles, n, state->energy_fraction);
+    state->preview = false;
+    if (!begin_animation(state, n, n, active_terms)) return false;
+    
+    mem_stats_t after = mem_stats();
+    state->last_start_allocs = (after.allocs - before.allocs) + (after.reallocs - before.reallocs);
+    return true;
+}
+
+bool app_start_animation_online(AppState *state) {
+    int n = state->drawing_points.count;
+    state->cache_key = 0;
+    if (n <= 0 || state->online.count != n) return false;
+    
+    mem_stats_t before = mem_stats();
+    app_cancel_transform(state);
+    state->spectrum_size = 0;
+    state->eval.count = 0;
+    
+    int size = state->online.size;
+    if (!mem_reserve((void **)&state->dft_result, &state->dft_result_capacity, size, sizeof(complex_t)) ||
+        !mem_reserve((void **)&state->epicycles, &state->epicycles_capacity, size, sizeof(epicycle_t))) {
+        return false;
+    }
+    
+    /* The spectrum is already accumulated; only the closing segment and the sort remain */
+    online_dft_spectrum(&state->online, &state->drawing_points, state->dft_result);
+    dft_to_epicycles_into(state->dft_result, state->epicycles, size, state->centered_freqs);
+    int active_terms = epicycles_terms_for_energy(state->epicycles, size, state->energy_fraction);
+    
+    state->preview = false;
+    if (!begin_animation(state, size, size, active_terms)) return false;
+    
+    mem_stats_t after = mem_stats();
+    state->last_start_allocs = (after.allocs - before.allocs) + (after.reallocs - before.reallocs);
+    return true;
+}
+
+/* ========== Background Transform ========== */
+
+/*
+ * A transform job owns a full set of transform buffers. The worker thread
+ * fills the job's buffers only; the main thread publishes a finished job
+ * by swapping its buffers with the AppState ones, so the state never sees
+ * a half-written spectrum. The swapped-out buffers stay with the job, which
+ * is kept as a spare for the next load (double buffering).
+ */
+struct transform_job {
+    platform_thread_t *thread;
+    volatile int status;        /* transform_status_t, written last by the worker */
+    volatile int cancel;        /* Set by the main thread when the job is superseded */
+    volatile int progress;      /* Permille */
+    
+    int n;
+    bool centered;
+    float energy_fraction;
+    int active_terms;
+    const char *cache_dir;      /* Store the result here under cache_key (NULL = don't) */
+    uint64_t cache_key;
+    
+    complex_t  *input;
+    complex_t  *result;
+    epicycle_t *epicycles;
+    int input_capacity;
+    int result_capacity;
+    int epicycles_capacity;
+    
+    struct transform_job *next; /* Retired list */
+};
+
+/*
+ * Coarse first pass: resample the drawing to m points evenly spaced in
+ * index (linear interpolation, wrapping), transform that on this thread and
+ * start animating it at the full input's step count. Only the centered
+ * spectrum is a smooth curve through the samples that can be evaluated at
+ * every full-resolution step (unsigned frequencies alias between them), so
+ * the preview is always centered, whatever state->centered_freqs says; the
+ * hot swap sorts the full spectrum for the user's mode. The state's
+ * buffers are free for this: the background job has its own.
+ */
+static bool start_preview(AppState *state, int m) {
+    const point_list_t *points = &state->drawing_points;
+    int n = points->count;
+    
+    if (!mem_reserve((void **)&state->dft_input, &state->dft_input_capacity, m, sizeof(complex_t)) ||
+        !mem_reserve((void **)&state->dft_result, &state->dft_result_capacity, m, sizeof(complex_t)) ||
+        !mem_reserve((void **)&state->epicycles, &state->epicycles_capacity, m, sizeof(epicycle_t))) {
+        return false;
+    }
+    
+    for (int j = 0; j < m; j++) {
+        double pos = (double)j * n / m;
+        int i = (int)pos;
+        float f = (float)(pos - i);
+        Vector2 a = points->data[i];
+        Vector2 b = points->data[(i + 1) % n];
+        state->dft_input[j].real = a.x + (b.x - a.x) * f;
+        state->dft_input[j].imag = a.y + (b.y - a.y) * f;
+    }
+    
+    int active_terms;
+    if (!transform_input(state->dft_input, state->dft_result, state->epicycles, m,
+                         true, state->energy_fraction, &active_terms)) {
+        return false;
+    }
+    state->preview = true;
+    return begin_animation(state, m, n, active_terms);
+}
+
+static void transform_worker(void *arg) {
+    transform_job_t *job = (transform_job_t *)arg;
+    int status = TRANSFORM_FAILED;
+    
+    /* The FFT itself cannot be interrupted; cancellation is checked between phases */
+    if (!platform_atomic_load(&job->cancel) && dft_into(job->input, job->result, job->n)) {
+        platform_atomic_store(&job->progress, 800);
+        if (!platform_atomic_load(&job->cancel)) {
+            dft_to_epicycles_into(job->result, job->epicycles, job->n, job->centered);
+            platform_atomic_store(&job->progress, 950);
+            job->active_terms = epicycles_terms_for_energy(job->epicycles, job->n, job->energy_fraction);
+            
+            /* Written here, so the frame loop never waits on the disk */
+            if (job->cache_dir) {
+                fcoef_store(job->cache_dir, job->cache_key, job->result, job->epicycles, job->n, job->centered);
+            }
+            status = TRANSFORM_DONE;
+        }
+    }
+    if (platform_atomic_load(&job->cancel)) status = TRANSFORM_CANCELLED;
+    
+    platform_atomic_store(&job->progress, 1000);
+    platform_atomic_store(&job->status, status);
+}
+
+static void transform_job_free(transform_job_t *job) {
+    if (!job) return;
+    mem_free(job->input);
+    mem_free(job->result);
+    mem_free(job->epicycles);
+    mem_free(job);
+}
+
+/* Join a job whose worker has finished and keep it as the spare (or free it) */
+static void recycle_job(AppState *state, transform_job_t *job) {
+    platform_thread_join(job->thread);
+    job->thread = NULL;
+    if (!state->spare_transform) {
+        state->spare_transform = job;
+    } else {
+        transform_job_free(job);
+    }
+}
+
+/* Join retired jobs that have finished; with `wait`, block until all have */
+static void reap_retired(AppState *state, bool wait) {
+    transform_job_t **link = &state->retired_transforms;
+    while (*link) {
+        transform_job_t *job = *link;
+        if (wait || platform_atomic_load(&job->status) != TRANSFORM_RUNNING) {
+            *link = job->next;
+            job->next = NULL;
+            recycle_job(state, job);
+        } else {
+            link = &job->next;
+        }
+    }
+}
+
+bool app_start_animation_async(AppState *state) {
+    int n = state->drawing_points.count;
+    if (n <= 0) return false;
+    uint64_t cache_key = state->cache_key;
     
+    mem_stats_t before = mem_stats();
+    app_cancel_transform(state);
+    reap_retired(state, false);
+    state->spectrum_size = 0;
+    state->eval.count = 0;
+    state->proceed = false;
+    
+    transform_job_t *job = state->spare_transform;
+    state->spare_transform = NULL;
+    if (!job) {
+        job = (transform_job_t *)mem_calloc(1, sizeof(transform_job_t));
+        if (!job) return false;
+    }
+    
+    if (!mem_reserve((void **)&job->input, &job->input_capacity, n, sizeof(complex_t)) ||
+        !mem_reserve((void **)&job->result, &job->result_capacity, n, sizeof(complex_t)) ||
+        !mem_reserve((void **)&job->epicycles, &job->epicycles_capacity, n, sizeof(epicycle_t))) {
+        state->spare_transform = job;
+        return false;
+    }
+    
+    /* The worker only sees this snapshot, so the drawing may change (and cancel) meanwhile */
+    fill_dft_input(&state->drawing_points, job->input);
+    job->n = n;
+    job->centered = state->centered_freqs;
+    job->energy_fraction = state->energy_fraction;
+    job->active_terms = 0;
+    job->cache_dir = cache_key ? state->coef_cache_dir : NULL;
+    job->cache_key = cache_key;
+    job->cancel = 0;
+    job->progress = 0;
+    job->status = TRANSFORM_RUNNING;
+    job->next = NULL;
+    
+    job->thread = platform_thread_start(transform_worker, job);
+    if (!job->thread) {
+        state->spare_transform = job;
+        return false;
+    }
+    state->transform = job;
+    state->cache_key = 0;
+    
+    /* Animate a decimated spectrum right away; the full one is swapped in when it lands */
+    state->preview = false;
+    if (n >= 2 * PROGRESSIVE_PREVIEW_POINTS && !start_preview(state, PROGRESSIVE_PREVIEW_POINTS)) {
+        state->spectrum_size = 0;
+        state->eval.count = 0;
+        state->proceed = false;
+    }
+    
+    mem_stats_t after = mem_stats();
+    state->last_start_allocs = (after.allocs - before.allocs) + (after.reallocs - before.reallocs);
     return true;
 }
 
+transform_status_t app_poll_transform(AppState *state) {
+    reap_retired(state, false);
+    
+    transform_job_t *job = state->transform;
+    if (!job) return TRANSFORM_IDLE;
+    
+    int status = platform_atomic_load(&job->status);
+    if (status == TRANSFORM_RUNNING) return TRANSFORM_RUNNING;
+    state->transform = NULL;
+    
+    if (status == TRANSFORM_DONE) {
+        /* Publish: the job's buffers become the state's, the old ones go back with the job */
+        complex_t *input = state->dft_input;
+        complex_t *result = state->dft_result;
+        epicycle_t *epicycles = state->epicycles;
+        int input_capacity = state->dft_input_capacity;
+        int result_capacity = state->dft_result_capacity;
+        int epicycles_capacity = state->epicycles_capacity;
+        
+        state->dft_input = job->input;
+        state->dft_result = job->result;
+        state->epicycles = job->epicycles;
+        state->dft_input_capacity = job->input_capacity;
+        state->dft_result_capacity = job->result_capacity;
+        state->epicycles_capacity = job->epicycles_capacity;
+        
+        job->input = input;
+        job->result = result;
+        job->epicycles = epicycles;
+        job->input_capacity = input_capacity;
+        job->result_capacity = result_capacity;
+        job->epicycles_capacity = epicycles_capacity;
+        
+        if (state->preview && state->proceed) {
+            /*
+             * Hot swap under the running preview: t, the clock and the trace
+             * carry on; only the spectrum and the evaluator change. Settings
+             * changed since the job started are applied here.
+             */
+            if (job->centered != state->centered_freqs) {
+                dft_to_epicycles_into(state->dft_result, state->epicycles, job->n, state->centered_freqs);
+            }
+            state->spectrum_size = job->n;
+            state->preview = false;
+            state->active_terms = 0;
+            app_set_energy_fraction(state, state->energy_fraction);
+        } else if (!begin_animation(state, job->n, job->n, job->active_terms)) {
+            status = TRANSFORM_FAILED;
+        }
+    }
+    
+    recycle_job(state, job);
+    return (transform_status_t)status;
+}
+
+float app_transform_progress(const AppState *state) {
+    if (!state->transform) return -1.0f;
+    return platform_atomic_load(&state->transform->progress) / 1000.0f;
+}
+
+void app_cancel_transform(AppState *state) {
+    transform_job_t *job = state->transform;
+    if (!job) return;
+    
+    /* Never wait for the worker here; it is joined once it notices (reap_retired) */
+    platform_atomic_store(&job->cancel, 1);
+    job->next = state->retired_transforms;
+    state->retired_transforms = job;
+    state->transform = NULL;
+}
+
+void app_set_energy_fraction(AppState *state, float fraction) {
+    state->energy_fraction = fraction;
+    if (state->spectrum_size <= 0) return;
+    
+    int terms = epicycles_terms_for_energy(state->epicycles, state->spectrum_size, fraction);
+    if (terms == state->active_terms) return;
+    
+    state->active_terms = terms;
+    if (epicycle_eval_setup(&state->eval, state->epicycles, terms, (2 * PI) / state->total_steps)) {
+        epicycle_eval_sync(&state->eval, state->t);
+    }
+    epicycle_soa_load(&state->soa, state->epicycles, terms);
+}
+
+int app_advance_animation(AppState *state, float frame_seconds) {
+    if (state->animation_done || state->spectrum_size <= 0) return 0;
+    
+    int n = state->total_steps;
+    int steps = step_clock_advance(&state->clock, frame_seconds * state->speed);
+    
+    for (int i = 0; i < steps && !state->animation_done; i++) {
+        /*
+         * Record current position; the arms are only needed once per frame,
+         * for drawing. The kernel gets the exact step instant: t picks up a
+         * rounding error per step, which high frequencies would amplify.
+         */
+        int step = (int)lroundf(state->t * n / (2 * PI));
+        point_list_push(&state->trace_points, epicycle_soa_position(&state->soa, (2 * PI * step) / n));
+        
+        state->current_k = (int)((state->t / (2 * PI)) * n) % n;
+        
+        /* Advance time */
+        state->t += (2 * PI) / n;
+        if (state->t >= 2 * PI) {
+            state->animation_done = true;
+            state->t = 2 * PI;
+        }
+    }
+    
+    epicycle_eval_sync(&state->eval, state->t);
+    return steps;
+}
+
+void app_set_centered_freqs(AppState *state, bool centered) {
+    state->centered_freqs = centered;
+    
+    /* A preview stays centered; the mode is applied when the full spectrum is swapped in */
+    if (state->spectrum_size <= 0 || state->preview) return;
+    
+    /* Rebuilt in place from the kept spectrum */
+    dft_to_epicycles_into(state->dft_result, state->epicycles, state->spectrum_size, centered);
+    
+    /* Force the evaluator to re-bind to the reordered array */
+    state->active_terms = 0;
+    app_set_energy_fraction(state, state->energy_fraction);
+}
+
 void app_reset(AppState *state) {
-    if (state->dft_result) { free(state->dft_result); state->dft_result = NULL; }
-    if (state->epicycles)  { free(state->epicycles);  state->epicycles = NULL; }
+    app_cancel_transform(state);
+    online_dft_reset(&state->online);
+    state->cache_key = 0;
+    
+    /* Buffers stay allocated for the next run */
+    state->spectrum_size = 0;
+    state->preview = false;
+    state->eval.count = 0;
+    state->active_terms = 0;
     
-    state->point_count = 0;
-    state->trace_count = 0;
+    /* Drop every session point at once; the arena keeps its memory for the next shape */
+    mem_arena_reset(&state->arena);
+    point_list_init(&state->drawing_points, &state->arena);
+    point_list_init(&state->trace_points, &state->arena);
+    point_list_init(&state->resample_scratch, &state->arena);
     state->t = 0.0f;
     state->proceed = false;
     state->animation_done = false;
     state->current_k = 0;
     state->was_drawing = false;
     state->is_drawing = false;
-    state->frame_time = 0.0f;
+    step_clock_reset(&state->clock);
     state->restart_clicked = true;
-}
\ No newline at end of file
+}
+
+void app_state_free(AppState *state) {
+    app_cancel_transform(state);
+    reap_retired(state, true);
+    transform_job_free(state->spare_transform);
+    state->spare_transform = NULL;
+    online_dft_free(&state->online);
+    
+    mem_free(state->dft_input);
+    mem_free(state->dft_result);
+    mem_free(state->epicycles);
+    state->dft_input = NULL;
+    state->dft_result = NULL;
+    state->epicycles = NULL;
+    state->dft_input_capacity = 0;
+    state->dft_result_capacity = 0;
+    state->epicycles_capacity = 0;
+    state->spectrum_size = 0;
+    epicycle_eval_free(&state->eval);
+    epicycle_soa_free(&state->soa);
+    mem_arena_free(&state->arena);
+    point_list_init(&state->drawing_points, &state->arena);
+    point_list_init(&state->trace_points, &state->arena);
+    point_list_init(&state->resample_scratch, &state->arena);
+}
@@ -7,6 +7,12 @@
 
 #define _CRT_SECURE_NO_WARNINGS
 #include "fourier.h"
+#include "fcoef.h"
+#include "fft.h"
+#include "task_pool.h"
+#include "simd.h"
+#include "mem.h"
+#include "render.h"
 #include "shapes.h"
 #include "ui.h"
 #include <string.h>
@@ -51,36 +57,82 @@ static void scan_shape_files(AppState *state) {
     }
 }
 
+/**
+ * Start the animation and log how many heap allocations the pipeline made
+ * (0 once its buffers and the FFT plan for this N are warm). Large inputs
+ * are transformed in the background and start once app_poll_transform()
+ * publishes them. Loaded files (`cached`) first try the coefficient cache.
+ */
+static bool start_animation(AppState *state, bool cached) {
+    /* Freehand input was transformed point by point while it was drawn (unless a resample size was asked for) */
+    if (state->online_transform && state->resample_mode == RESAMPLE_OFF && 
+        state->online.count == state->drawing_points.count && app_start_animation_online(state)) {
+        TraceLog(LOG_INFO, "FOURIER: N = %d on a %d-sample online grid, %d terms, %d heap allocations", 
+                 state->drawing_points.count, state->spectrum_size, state->active_terms, state->last_start_allocs);
+        return true;
+    }
+    
+    /* Even arc-length spacing at the policy's size; the input layer then shows the samples */
+    int loaded = state->drawing_points.count;
+    if (app_resample_input(state)) {
+        render_invalidate(RENDER_LAYER_INPUT);
+        TraceLog(LOG_INFO, "FOURIER: resampled %d points to %d by arc length", loaded, state->drawing_points.count);
+    }
+    
+    /* A shape transformed before (same points, same size) maps its stored coefficients */
+    if (cached && app_start_animation_cached(state)) {
+        TraceLog(LOG_INFO, "FOURIER: N = %d from the coefficient cache, %d terms, %d heap allocations",
+                 state->spectrum_size, state->active_terms, state->last_start_allocs);
+        return true;
+    }
+    
+    if (state->drawing_points.count >= ASYNC_TRANSFORM_MIN_POINTS && app_start_animation_async(state)) {
+        TraceLog(LOG_INFO, "FOURIER: N = %d, transforming in the background", state->drawing_points.count);
+        return true;
+    }
+    if (!app_start_animation(state)) return false;
+    TraceLog(LOG_INFO, "FOURIER: N = %d, %d terms, %d heap allocations", 
+             state->spectrum_size, state->active_terms, state->last_start_allocs);
+    return true;
+}
+
 /**
  * Load a shape file (SVG or TXT) into the drawing points.
  */
 static bool load_file_into_state(AppState *state, const char *filepath, float center_x, float center_y) {
     int len = (int)strlen(filepath);
+    point_list_clear(&state->drawing_points);
+    online_dft_reset(&state->online);
+    render_invalidate(RENDER_LAYER_INPUT);
     
     if (len > 4 && (strcmp(&filepath[len-4], ".svg") == 0 || strcmp(&filepath[len-4], ".SVG") == 0)) {
-        state->point_count = load_svg_file(state->drawing_points, filepath, center_x, center_y, 
-                                           DEFAULT_LOAD_SCALE, DRAWING_POINTS_MAX);
+        load_svg_file(&state->drawing_points, filepath, center_x, center_y, DEFAULT_LOAD_SCALE);
     } else if (len > 4 && (strcmp(&filepath[len-4], ".txt") == 0 || strcmp(&filepath[len-4], ".TXT") == 0)) {
-        state->point_count = load_shape_from_file(state->drawing_points, filepath, center_x, center_y, 
-                                                  DEFAULT_LOAD_SCALE, DRAWING_POINTS_MAX);
+        load_shape_from_file(&state->drawing_points, filepath, center_x, center_y, DEFAULT_LOAD_SCALE);
     } else {
         return false;
     }
     
-    return state->point_count > 0;
+    return state->drawing_points.count > 0;
 }
 
 /**
  * Generate a preset shape and start animation.
  */
 static void generate_preset_shape(AppState *state, int shape_index, float center_x, float center_y) {
+    point_list_t *list = &state->drawing_points;
+    if (!point_list_reserve(list, DEFAULT_SHAPE_POINTS)) return;
+    online_dft_reset(&state->online);
+    render_invalidate(RENDER_LAYER_INPUT);
+    
+    Vector2 *points = list->data;
     switch (shape_index) {
-        case 0: state->point_count = generate_circle(state->drawing_points, center_x, center_y, DEFAULT_SHAPE_SIZE, DEFAULT_SHAPE_POINTS); break;
-        case 1: state->point_count = generate_square(state->drawing_points, center_x, center_y, DEFAULT_SHAPE_SIZE * 2, DEFAULT_SHAPE_POINTS); break;
-        case 2: state->point_count = generate_star(state->drawing_points, center_x, center_y, DEFAULT_SHAPE_SIZE, DEFAULT_SHAPE_SIZE * 0.4f, 5, DEFAULT_SHAPE_POINTS); break;
-        case 3: state->point_count = generate_heart(state->drawing_points, center_x, center_y, DEFAULT_SHAPE_SIZE * 0.9f, DEFAULT_SHAPE_POINTS); break;
-        case 4: state->point_count = generate_infinity(state->drawing_points, center_x, center_y, DEFAULT_SHAPE_SIZE * 1.5f, DEFAULT_SHAPE_POINTS); break;
-        case 5: state->point_count = generate_spiral(state->drawing_points, center_x, center_y, DEFAULT_SHAPE_SIZE, DEFAULT_SHAPE_POINTS); break;
+        case 0: list->count = generate_circle(points, center_x, center_y, DEFAULT_SHAPE_SIZE, DEFAULT_SHAPE_POINTS); break;
+        case 1: list->count = generate_square(points, center_x, center_y, DEFAULT_SHAPE_SIZE * 2, DEFAULT_SHAPE_POINTS); break;
+        case 2: list->count = generate_star(points, center_x, center_y, DEFAULT_SHAPE_SIZE, DEFAULT_SHAPE_SIZE * 0.4f, 5, DEFAULT_SHAPE_POINTS); break;
+        case 3: list->count = generate_heart(points, center_x, center_y, DEFAULT_SHAPE_SIZE * 0.9f, DEFAULT_SHAPE_POINTS); break;
+        case 4: list->count = generate_infinity(points, center_x, center_y, DEFAULT_SHAPE_SIZE * 1.5f, DEFAULT_SHAPE_POINTS); break;
+        case 5: list->count = generate_spiral(points, center_x, center_y, DEFAULT_SHAPE_SIZE, DEFAULT_SHAPE_POINTS); break;
     }
 }
 
@@ -97,10 +149,11 @@ static void handle_drag_drop(AppState *state) {
         
         /* Reset current animation */
         app_reset(state);
+        render_invalidate(RENDER_LAYER_ALL);
         state->restart_clicked = false; /* Don't block drawing */
         
         if (load_file_into_state(state, dropped.paths[0], center_x, center_y)) {
-            app_start_animation(state);
+            start_animation(state, true);
         }
     }
     UnloadDroppedFiles(dropped);
@@ -110,10 +163,30 @@ static void handle_drag_drop(AppState *state) {
  * Draw the current drawing points (user's raw input).
  */
 static void draw_input_path(AppState *state) {
-    for (int i = 0; i < state->point_count - 1; i++) {
-        DrawLine((int)state->drawing_points[i].x, (int)state->drawing_points[i].y, 
-                 (int)state->drawing_points[i + 1].x, (int)state->drawing_points[i + 1].y, WHITE);
-    }
+    /* Only segments added while drawing are rasterized; the rest comes from the input layer */
+    input_layer_update(&state->drawing_points);
+    input_layer_draw();
+}
+
+/**
+ * Draw the progress bar of a background transform, if one is running.
+ */
+static void draw_transform_progress(const AppState *state) {
+    float progress = app_transform_progress(state);
+    if (progress < 0.0f) return;
+    
+    int width = 360;
+    int x = (WINDOW_WIDTH - width) / 2;
+    int y = WINDOW_HEIGHT - 80;
+    
+    DrawText(TextFormat("Computing %d-point transform... %.0f%%", state->drawing_points.count, progress * 100), 
+             x, y - 24, 16, COLOR_LABEL);
+    DrawRectangle(x, y, width, 8, COLOR_PANEL_BORDER);
+    DrawRectangle(x, y, (int)(width * progress), 8, COLOR_ACCENT);
+    
+    /* Moving marker so the bar visibly lives while the FFT runs */
+    int marker = (int)(fmod(GetTime(), 1.5) / 1.5 * (width - 40));
+    DrawRectangle(x + marker, y, 40, 8, (Color){ 150, 190, 255, 160 });
 }
 
 /**
@@ -122,74 +195,59 @@ static void draw_input_path(AppState *state) {
 static void draw_trace_path(AppState *state, Vector2 current_tip) {
     Color base_color = get_trace_color(state->color_index);
     
-    /* Draw recorded trace points with gradient based on selected color */
-    for (int i = 0; i < state->trace_count - 1; i++) {
-        float alpha = (float)i / (state->trace_count > 1 ? state->trace_count : 1);
-        /* Blend from darker to full color */
-        Color trace_color = (Color){
-            (unsigned char)(base_color.r * (0.3f + 0.7f * alpha)),
-            (unsigned char)(base_color.g * (0.3f + 0.7f * alpha)),
-            (unsigned char)(base_color.b * (0.3f + 0.7f * alpha)),
-            255
-        };
-        DrawLineEx(state->trace_points[i], state->trace_points[i + 1], state->line_thickness, trace_color);
-    }
+    /* Recorded trace: only new segments are rendered, the rest comes from the trace layer */
+    trace_layer_update(&state->trace_points, state->total_steps, base_color, state->line_thickness);
+    trace_layer_draw();
     
     /* Connect last trace point to current tip with bright color */
-    if (state->trace_count > 0) {
+    if (state->trace_points.count > 0) {
         Color tip_color = (Color){
             (unsigned char)(base_color.r > 200 ? 255 : base_color.r + 55),
             (unsigned char)(base_color.g > 200 ? 255 : base_color.g + 55),
             (unsigned char)(base_color.b > 200 ? 255 : base_color.b + 55),
             255
         };
-        DrawLineEx(state->trace_points[state->trace_count - 1], current_tip, 
+        DrawLineEx(state->trace_points.data[state->trace_points.count - 1], current_tip, 
                    state->line_thickness, tip_color);
     }
 }
 
-/**
- * Update animation state (advance time, record trace).
- */
-static void update_animation(AppState *state, Vector2 current_tip) {
-    if (state->animation_done) return;
-    
-    state->frame_time += GetFrameTime() * state->speed;
-    
-    float step_time = 1.0f / 60.0f;
-    if (state->frame_time >= step_time) {
-        state->frame_time -= step_time;
-        
-        /* Record current position */
-        state->trace_points[state->trace_count] = current_tip;
-        state->trace_count++;
-        
-        state->current_k = (int)((state->t / (2 * PI)) * state->point_count) % state->point_count;
-        
-        /* Advance time */
-        state->t += (2 * PI) / state->point_count;
-        if (state->t >= 2 * PI) {
-            state->animation_done = true;
-            state->t = 2 * PI;
-        }
-    }
-}
-
 /**
  * Draw the animation panel (shown when animating).
  */
 static void draw_animation_panel(AppState *state, int *y_pos) {
-    /* Stats row */
+    /* Stats row: input points and the transform length L (the online grid or preview can differ) */
     DrawText("N:", PANEL_X + PANEL_PADDING, *y_pos, 16, COLOR_LABEL);
-    DrawText(TextFormat("%d", state->point_count), PANEL_X + 35, *y_pos, 16, COLOR_VALUE);
+    const char *count_text = TextFormat("%d", state->drawing_points.count);
+    DrawText(count_text, PANEL_X + 35, *y_pos, 16, COLOR_VALUE);
+    int l_x = PANEL_X + 35 + MeasureText(count_text, 16) + 6;
+    const char *length_text = TextFormat("(L %d)", state->spectrum_size);
+    DrawText(length_text, l_x, *y_pos + 2, 14, COLOR_LABEL);
     
-    DrawText("t:", PANEL_X + 100, *y_pos, 16, COLOR_LABEL);
-    DrawText(TextFormat("%.2f", state->t), PANEL_X + 115, *y_pos, 16, COLOR_VALUE);
+    int t_x = l_x + MeasureText(length_text, 14) + 12;
+    if (t_x < PANEL_X + 100) t_x = PANEL_X + 100;
+    DrawText("t:", t_x, *y_pos, 16, COLOR_LABEL);
+    DrawText(TextFormat("%.2f", state->t), t_x + 15, *y_pos, 16, COLOR_VALUE);
     
     float progress = (state->t / (2 * PI)) * 100;
     DrawText(TextFormat("%.0f%%", progress), PANEL_X + PANEL_WIDTH - 50, *y_pos, 16, 
              state->animation_done ? GREEN : YELLOW);
-    *y_pos += ROW_HEIGHT + 5;
+    *y_pos += ROW_HEIGHT;
+    
+    /* Epicycle geometry submitted this frame */
+    render_stats_t render = render_last_stats();
+    DrawText(TextFormat("%d verts, %d call%s, +%d trace", render.vertices, render.batches, 
+                        render.batches == 1 ? "" : "s", render.trace_segments),
+             PANEL_X + PANEL_PADDING, *y_pos, 14, (Color){150, 150, 170, 255});
+    *y_pos += 20;
+    
+    /* Fixed-step scheduler: steps run this frame and frames that had to drop time */
+    DrawText(TextFormat("%d step%s/frame, %d stall%s", state->clock.last_steps, 
+                        state->clock.last_steps == 1 ? "" : "s", 
+                        state->clock.stalls, state->clock.stalls == 1 ? "" : "s"),
+             PANEL_X + PANEL_PADDING, *y_pos, 14, 
+             state->clock.stalls > 0 ? YELLOW : (Color){150, 150, 170, 255});
+    *y_pos += 20;
     
     draw_panel_separator(*y_pos);
     *y_pos += 12;
@@ -198,8 +256,10 @@ static void draw_animation_panel(AppState *state, int *y_pos) {
     DrawText("Current Coefficient", PANEL_X + PANEL_PADDING, *y_pos, 14, COLOR_LABEL);
     *y_pos += 20;
     
-    if (state->point_count > 0 && state->dft_result != NULL) {
-        int k = state->current_k < state->point_count ? state->current_k : 0;
+    if (state->spectrum_size > 0) {
+        /* current_k counts trace steps; a preview has fewer bins than the run has steps */
+        int k = (int)((int64_t)state->current_k * state->spectrum_size / state->total_steps);
+        if (k >= state->spectrum_size) k = state->spectrum_size - 1;
         float real_val = state->dft_result[k].real;
         float imag_val = state->dft_result[k].imag;
         
@@ -212,8 +272,9 @@ static void draw_animation_panel(AppState *state, int *y_pos) {
                  PANEL_X + PANEL_PADDING, *y_pos, 16, COLOR_VALUE);
         *y_pos += 22;
         
-        float amp = state->epicycles[k].amplitude;
-        float phase = state->epicycles[k].phase;
+        /* Epicycles are sorted by amplitude, so read bin k straight from the spectrum */
+        float amp = complex_magnitude(&state->dft_result[k]);
+        float phase = complex_phase(&state->dft_result[k]);
         DrawText(TextFormat("|X| = %.2f   phi = %.2f", amp, phase), 
                  PANEL_X + PANEL_PADDING, *y_pos, 14, (Color){150, 150, 170, 255});
     }
@@ -227,19 +288,43 @@ static void draw_animation_panel(AppState *state, int *y_pos) {
                               state->speed, 0.1f, 5.0f, "Speed");
     *y_pos += 55;
     
+    /* Term budget slider (percent of spectral energy kept) */
+    float energy_pct = draw_slider_ex(PANEL_X + PANEL_PADDING, *y_pos + 20, PANEL_WIDTH - 2 * PANEL_PADDING, 
+                                      state->energy_fraction * 100.0f, 90.0f, 100.0f, 
+                                      TextFormat("Energy (%d of %d terms%s)", state->active_terms, state->spectrum_size, 
+                                                 state->preview ? ", preview" : ""), 
+                                      "%.1f%%");
+    if (energy_pct != state->energy_fraction * 100.0f) {
+        app_set_energy_fraction(state, energy_pct / 100.0f);
+    }
+    *y_pos += 55;
+    
+    /* Frequency mapping toggle */
+    if (draw_button(PANEL_X + PANEL_PADDING, *y_pos, PANEL_WIDTH - 2 * PANEL_PADDING, 28, 
+                   state->centered_freqs ? "Frequencies: Signed" : "Frequencies: 0..N-1", 
+                   COLOR_BTN_DEFAULT, COLOR_BTN_HOVER)) {
+        app_set_centered_freqs(state, !state->centered_freqs);
+    }
+    *y_pos += 40;
+    
     /* Line thickness slider */
     state->line_thickness = draw_slider(PANEL_X + PANEL_PADDING, *y_pos + 20, PANEL_WIDTH - 2 * PANEL_PADDING, 
                                        state->line_thickness, 0.5f, 8.0f, "Line Size");
     *y_pos += 55;
     
     /* Color picker */
-    state->color_index = draw_color_picker(PANEL_X + PANEL_PADDING, *y_pos, state->color_index);
+    int color_index = draw_color_picker(PANEL_X + PANEL_PADDING, *y_pos, state->color_index);
+    if (color_index != state->color_index) {
+        state->color_index = color_index;
+        render_invalidate(RENDER_LAYER_TRACE);
+    }
     *y_pos += 60;
     
     /* Restart button */
     if (draw_button(PANEL_X + PANEL_PADDING, *y_pos, PANEL_WIDTH - 2 * PANEL_PADDING, 35, 
                    "RESTART", (Color){60, 70, 100, 255}, (Color){80, 100, 140, 255})) {
         app_reset(state);
+        render_invalidate(RENDER_LAYER_ALL);
     }
 }
 
@@ -296,7 +381,7 @@ static void draw_file_picker(AppState *state, float center_x, float center_y, bo
             snprintf(filepath, sizeof(filepath), "shapes/%s", state->shape_files[i]);
             
             if (load_file_into_state(state, filepath, center_x, center_y)) {
-                app_start_animation(state);
+                start_animation(state, true);
                 state->show_file_picker = false;
             }
             state->restart_clicked = true;
@@ -335,7 +420,7 @@ static void draw_input_panel(AppState *state, int *y_pos) {
         if (draw_button(btn_x, btn_y, btn_width, btn_height, SHAPE_NAMES[i],
                        COLOR_BTN_DEFAULT, COLOR_BTN_HOVER)) {
             generate_preset_shape(state, i, center_x, center_y);
-            app_start_animation(state);
+            start_animation(state, false);
             state->restart_clicked = true;
         }
     }
@@ -355,6 +440,40 @@ static void draw_input_panel(AppState *state, int *y_pos) {
         state->show_file_picker = !state->show_file_picker;
         state->restart_clicked = true;
     }
+    *y_pos += btn_height + 8;
+    
+    /* Online transform toggle (applies to the next freehand drawing) */
+    if (draw_button(PANEL_X + PANEL_PADDING, *y_pos, PANEL_WIDTH - 2 * PANEL_PADDING, 28, 
+                   state->online_transform ? "Transform while drawing: On" : "Transform while drawing: Off", 
+                   COLOR_BTN_DEFAULT, COLOR_BTN_HOVER)) {
+        state->online_transform = !state->online_transform;
+        online_dft_reset(&state->online);
+        state->restart_clicked = true;
+    }
+    *y_pos += 36;
+    
+    /* Resampling policy (cycles Off -> power of two -> fixed M), with -/+ halving and doubling M */
+    int step_width = 28;
+    bool fixed = state->resample_mode == RESAMPLE_FIXED;
+    int mode_width = PANEL_WIDTH - 2 * PANEL_PADDING - (fixed ? 2 * (step_width + 6) : 0);
+    const char *mode_text = state->resample_mode == RESAMPLE_POW2 ? "Resample: Power of two"
+                          : fixed ? TextFormat("Resample: %d", state->resample_points)
+                          : "Resample: Off";
+    if (draw_button(PANEL_X + PANEL_PADDING, *y_pos, mode_width, 28, mode_text, COLOR_BTN_DEFAULT, COLOR_BTN_HOVER)) {
+        state->resample_mode = (resample_mode_t)((state->resample_mode + 1) % (RESAMPLE_FIXED + 1));
+        state->restart_clicked = true;
+    }
+    if (fixed) {
+        int step_x = PANEL_X + PANEL_PADDING + mode_width + 6;
+        if (draw_button(step_x, *y_pos, step_width, 28, "-", COLOR_BTN_DEFAULT, COLOR_BTN_HOVER)) {
+            if (state->resample_points / 2 >= RESAMPLE_MIN_POINTS) state->resample_points /= 2;
+            state->restart_clicked = true;
+        }
+        if (draw_button(step_x + step_width + 6, *y_pos, step_width, 28, "+", COLOR_BTN_DEFAULT, COLOR_BTN_HOVER)) {
+            if (state->resample_points * 2 <= RESAMPLE_MAX_POINTS) state->resample_points *= 2;
+            state->restart_clicked = true;
+        }
+    }
     
     /* Draw drop hint at bottom */
     DrawText("Drag & drop SVG or TXT file anywhere", 
@@ -368,15 +487,19 @@ int main(void) {
     InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, WINDOW_TITLE);
     SetTargetFPS(60);
     
+    /* Pick the epicycle summation kernel for this CPU */
+    TraceLog(LOG_INFO, "FOURIER: Epicycle kernel: %s", simd_path_name(simd_init()));
+    
     /* Initialize application state */
     AppState state;
     app_state_init(&state);
+    state.coef_cache_dir = FCOEF_CACHE_DIR;
     scan_shape_files(&state);
     
     /* Main loop */
     while (!WindowShouldClose()) {
         /* Calculate panel dimensions */
-        int panel_height = state.proceed ? 460 : 290;  /* Increased for color picker */
+        int panel_height = state.proceed ? 590 : 370;  /* Increased for color picker, term budget and render stats */
         Rectangle panel_rect = { (float)PANEL_X, (float)PANEL_Y, (float)PANEL_WIDTH, (float)panel_height };
         bool mouse_on_panel = CheckCollisionPointRec(GetMousePosition(), panel_rect);
         
@@ -388,20 +511,31 @@ int main(void) {
         /* Handle drag and drop */
         handle_drag_drop(&state);
         
-        /* Handle mouse drawing */
-        if (IsMouseButtonDown(MOUSE_BUTTON_LEFT) && !mouse_on_panel && !state.restart_clicked && !state.proceed) {
-            if (state.point_count < DRAWING_POINTS_MAX) {
-                state.drawing_points[state.point_count] = GetMousePosition();
-                state.point_count++;
+        /* Handle mouse drawing (not over a shape that is still being transformed) */
+        if (IsMouseButtonDown(MOUSE_BUTTON_LEFT) && !mouse_on_panel && !state.restart_clicked && !state.proceed &&
+            !state.transform) {
+            if (point_list_push(&state.drawing_points, GetMousePosition())) {
                 state.is_drawing = true;
+                
+                /* Keep the spectrum current so releasing the mouse starts the animation at once */
+                if (state.online_transform) online_dft_update(&state.online, &state.drawing_points);
             }
         } else if (!IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
             state.is_drawing = false;
         }
         
         /* Trigger animation when drawing ends */
-        if (!state.is_drawing && state.was_drawing && !state.proceed && state.point_count > 0) {
-            app_start_animation(&state);
+        if (!state.is_drawing && state.was_drawing && !state.proceed && state.drawing_points.count > 0) {
+            start_animation(&state, false);
+        }
+        
+        /* Publish a background transform once its worker is done */
+        transform_status_t transform_status = app_poll_transform(&state);
+        if (transform_status == TRANSFORM_DONE) {
+            TraceLog(LOG_INFO, "FOURIER: N = %d, %d terms (background transform)", 
+                     state.spectrum_size, state.active_terms);
+        } else if (transform_status == TRANSFORM_FAILED) {
+            TraceLog(LOG_WARNING, "FOURIER: background transform failed");
         }
         
         /* ========== Rendering ========== */
@@ -410,25 +544,22 @@ int main(void) {
         
         /* Draw input path */
         draw_input_path(&state);
+        draw_transform_progress(&state);
         
         /* Animation rendering */
         if (state.proceed) {
-            Vector2 tip = draw_epicycles(state.epicycles, state.point_count, state.t, state.line_thickness);
+            /* Run every step due since the last frame, then draw between steps */
+            app_advance_animation(&state, GetFrameTime());
+            float alpha = state.animation_done ? 0.0f : step_clock_alpha(&state.clock);
+            Vector2 tip = draw_epicycles(&state.eval, state.line_thickness, alpha);
             draw_trace_path(&state, tip);
-            update_animation(&state, tip);
         }
         
         /* ========== UI Panel ========== */
-        DrawRectangleRounded(panel_rect, 0.05f, 8, COLOR_PANEL_BG);
-        DrawRectangleRoundedLines(panel_rect, 0.05f, 8, COLOR_PANEL_BORDER);
-        
-        int y_pos = PANEL_Y + PANEL_PADDING;
+        /* Background, border, title and separator come from the cached panel layer */
+        panel_layer_draw(panel_rect, "FOURIER VISUALIZER");
         
-        /* Title */
-        DrawText("FOURIER VISUALIZER", PANEL_X + PANEL_PADDING, y_pos, 20, COLOR_ACCENT);
-        y_pos += 30;
-        draw_panel_separator(y_pos);
-        y_pos += 15;
+        int y_pos = PANEL_Y + PANEL_PADDING + 30 + 15;
         
         if (state.proceed) {
             draw_animation_panel(&state, &y_pos);
@@ -442,8 +573,10 @@ int main(void) {
     }
     
     /* Cleanup */
-    if (state.dft_result) free(state.dft_result);
-    if (state.epicycles) free(state.epicycles);
+    app_state_free(&state);
+    render_shutdown();
+    fft_cache_clear();
+    task_pool_shutdown();
     CloseWindow();
     
     return 0;
@@ -0,0 +1,178 @@
+/**
+ * mem.c - Counted Heap Allocation Implementation
+ */
+
+#include "mem.h"
+#include "platform.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MEM_ARENA_ALIGN  16
+
+struct mem_arena_block {
+    mem_arena_block_t *next;    /* Older block */
+    size_t used;
+    size_t capacity;
+    size_t pad;                 /* Keeps data[] 16-byte aligned on 32-bit targets */
+};
+
+#define BLOCK_DATA(block)  ((char *)(block) + sizeof(mem_arena_block_t))
+
+static volatile int alloc_count;
+static volatile int realloc_count;
+static volatile int free_count;
+
+/* ========== Allocation ========== */
+
+void *mem_alloc(size_t size)
+{
+    void *ptr = malloc(size);
+    if (ptr) platform_atomic_add(&alloc_count, 1);
+    return ptr;
+}
+
+void *mem_calloc(size_t count, size_t size)
+{
+    void *ptr = calloc(count, size);
+    if (ptr) platform_atomic_add(&alloc_count, 1);
+    return ptr;
+}
+
+void *mem_realloc(void *ptr, size_t size)
+{
+    void *result = realloc(ptr, size);
+    if (result) platform_atomic_add(ptr ? &realloc_count : &alloc_count, 1);
+    return result;
+}
+
+void mem_free(void *ptr)
+{
+    if (!ptr) return;
+    platform_atomic_add(&free_count, 1);
+    free(ptr);
+}
+
+bool mem_reserve(void **ptr, int *capacity, int count, size_t elem_size)
+{
+    if (count <= *capacity) return true;
+
+    int new_capacity = *capacity > 0 ? *capacity : 16;
+    while (new_capacity < count) {
+        if (new_capacity > (1 << 29)) return false;
+        new_capacity *= 2;
+    }
+
+    void *result = mem_realloc(*ptr, (size_t)new_capacity * elem_size);
+    if (!result) return false;
+    *ptr = result;
+    *capacity = new_capacity;
+    return true;
+}
+
+/* ========== Arena ========== */
+
+static size_t align_up(size_t size)
+{
+    return (size + (MEM_ARENA_ALIGN - 1)) & ~(size_t)(MEM_ARENA_ALIGN - 1);
+}
+
+static mem_arena_block_t *arena_new_block(size_t capacity)
+{
+    mem_arena_block_t *block = (mem_arena_block_t *)mem_alloc(sizeof(mem_arena_block_t) + capacity);
+    if (!block) return NULL;
+    block->next = NULL;
+    block->used = 0;
+    block->capacity = capacity;
+    return block;
+}
+
+void mem_arena_init(mem_arena_t *arena, size_t block_size)
+{
+    arena->head = NULL;
+    arena->block_size = block_size ? align_up(block_size) : MEM_ARENA_BLOCK_SIZE;
+    arena->last = NULL;
+}
+
+void *mem_arena_alloc(mem_arena_t *arena, size_t size)
+{
+    size = align_up(size ? size : 1);
+
+    mem_arena_block_t *block = arena->head;
+    if (!block || block->capacity - block->used < size) {
+        block = arena_new_block(size > arena->block_size ? size : arena->block_size);
+        if (!block) return NULL;
+        block->next = arena->head;
+        arena->head = block;
+    }
+
+    void *ptr = BLOCK_DATA(block) + block->used;
+    block->used += size;
+    arena->last = ptr;
+    return ptr;
+}
+
+void *mem_arena_grow(mem_arena_t *arena, void *ptr, size_t old_size, size_t new_size)
+{
+    if (!ptr) return mem_arena_alloc(arena, new_size);
+    if (new_size <= old_size) return ptr;
+
+    /* The newest allocation ends at head->used, so it can be extended in place */
+    mem_arena_block_t *block = arena->head;
+    if (ptr == arena->last) {
+        size_t offset = (size_t)((char *)ptr - BLOCK_DATA(block));
+        size_t size = align_up(new_size);
+        if (block->capacity - offset >= size) {
+            block->used = offset + size;
+            return ptr;
+        }
+    }
+
+    void *result = mem_arena_alloc(arena, new_size);
+    if (!result) return NULL;
+    memcpy(result, ptr, old_size);
+    return result;
+}
+
+void mem_arena_reset(mem_arena_t *arena)
+{
+    mem_arena_block_t *block = arena->head;
+    arena->last = NULL;
+    if (!block) return;
+
+    if (block->next) {
+        size_t total = 0;
+        while (block) {
+            mem_arena_block_t *next = block->next;
+            total += block->capacity;
+            mem_free(block);
+            block = next;
+        }
+        /* On failure the arena is simply empty and grows again on demand */
+        arena->head = arena_new_block(total);
+        return;
+    }
+    block->used = 0;
+}
+
+void mem_arena_free(mem_arena_t *arena)
+{
+    mem_arena_block_t *block = arena->head;
+    while (block) {
+        mem_arena_block_t *next = block->next;
+        mem_free(block);
+        block = next;
+    }
+    arena->head = NULL;
+    arena->last = NULL;
+}
+
+/* ========== Counters ========== */
+
+mem_stats_t mem_stats(void)
+{
+    mem_stats_t stats;
+    stats.allocs   = platform_atomic_load(&alloc_count);
+    stats.reallocs = platform_atomic_load(&realloc_count);
+    stats.frees    = platform_atomic_load(&free_count);
+    return stats;
+}
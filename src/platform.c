@@ -0,0 +1,330 @@
+/**
+ * platform.c - OS Abstraction Implementation
+ *
+ * Must not include raylib.h (name clashes with <windows.h>).
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+#include "platform.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+    #include <io.h>
+#else
+    #include <dirent.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <time.h>
+    #include <unistd.h>
+#endif
+
+/* ========== Mutex ========== */
+
+#if defined(_WIN32)
+
+void platform_mutex_lock(platform_mutex_t *m)   { AcquireSRWLockExclusive((PSRWLOCK)&m->lock); }
+void platform_mutex_unlock(platform_mutex_t *m) { ReleaseSRWLockExclusive((PSRWLOCK)&m->lock); }
+
+void platform_cond_wait(platform_cond_t *c, platform_mutex_t *m)
+{
+    SleepConditionVariableSRW((PCONDITION_VARIABLE)&c->cond, (PSRWLOCK)&m->lock, INFINITE, 0);
+}
+
+void platform_cond_broadcast(platform_cond_t *c) { WakeAllConditionVariable((PCONDITION_VARIABLE)&c->cond); }
+
+#else
+
+void platform_mutex_lock(platform_mutex_t *m)   { pthread_mutex_lock(&m->lock); }
+void platform_mutex_unlock(platform_mutex_t *m) { pthread_mutex_unlock(&m->lock); }
+
+void platform_cond_wait(platform_cond_t *c, platform_mutex_t *m) { pthread_cond_wait(&c->cond, &m->lock); }
+void platform_cond_broadcast(platform_cond_t *c)                 { pthread_cond_broadcast(&c->cond); }
+
+#endif
+
+/* ========== Threads ========== */
+
+struct platform_thread {
+    platform_thread_fn fn;
+    void *arg;
+#if defined(_WIN32)
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+};
+
+#if defined(_WIN32)
+
+static DWORD WINAPI thread_entry(LPVOID param)
+{
+    platform_thread_t *thread = (platform_thread_t *)param;
+    thread->fn(thread->arg);
+    return 0;
+}
+
+platform_thread_t *platform_thread_start(platform_thread_fn fn, void *arg)
+{
+    platform_thread_t *thread = (platform_thread_t *)malloc(sizeof(platform_thread_t));
+    if (!thread) return NULL;
+    thread->fn = fn;
+    thread->arg = arg;
+    thread->handle = CreateThread(NULL, 0, thread_entry, thread, 0, NULL);
+    if (!thread->handle) { free(thread); return NULL; }
+    return thread;
+}
+
+void platform_thread_join(platform_thread_t *thread)
+{
+    if (!thread) return;
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+    free(thread);
+}
+
+int platform_cpu_count(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+}
+
+#else
+
+static void *thread_entry(void *param)
+{
+    platform_thread_t *thread = (platform_thread_t *)param;
+    thread->fn(thread->arg);
+    return NULL;
+}
+
+platform_thread_t *platform_thread_start(platform_thread_fn fn, void *arg)
+{
+    platform_thread_t *thread = (platform_thread_t *)malloc(sizeof(platform_thread_t));
+    if (!thread) return NULL;
+    thread->fn = fn;
+    thread->arg = arg;
+    if (pthread_create(&thread->handle, NULL, thread_entry, thread) != 0) { free(thread); return NULL; }
+    return thread;
+}
+
+void platform_thread_join(platform_thread_t *thread)
+{
+    if (!thread) return;
+    pthread_join(thread->handle, NULL);
+    free(thread);
+}
+
+int platform_cpu_count(void)
+{
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+#endif
+
+/* ========== Atomics ========== */
+
+#if defined(_WIN32)
+
+int platform_atomic_add(volatile int *value, int delta)
+{
+    return (int)InterlockedExchangeAdd((volatile LONG *)value, (LONG)delta) + delta;
+}
+
+int platform_atomic_load(volatile int *value)
+{
+    return (int)InterlockedCompareExchange((volatile LONG *)value, 0, 0);
+}
+
+void platform_atomic_store(volatile int *value, int new_value)
+{
+    InterlockedExchange((volatile LONG *)value, (LONG)new_value);
+}
+
+#else
+
+int platform_atomic_add(volatile int *value, int delta)
+{
+    return __atomic_add_fetch(value, delta, __ATOMIC_SEQ_CST);
+}
+
+int platform_atomic_load(volatile int *value)
+{
+    return __atomic_load_n(value, __ATOMIC_SEQ_CST);
+}
+
+void platform_atomic_store(volatile int *value, int new_value)
+{
+    __atomic_store_n(value, new_value, __ATOMIC_SEQ_CST);
+}
+
+#endif
+
+/* ========== Time ========== */
+
+double platform_time_seconds(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+/* ========== Files ========== */
+
+bool platform_is_dir(const char *path)
+{
+#if defined(_WIN32)
+    DWORD attrib = GetFileAttributesA(path);
+    return attrib != INVALID_FILE_ATTRIBUTES && (attrib & FILE_ATTRIBUTE_DIRECTORY);
+#else
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+#endif
+}
+
+bool platform_make_dir(const char *path)
+{
+#if defined(_WIN32)
+    if (CreateDirectoryA(path, NULL)) return true;
+#else
+    if (mkdir(path, 0777) == 0) return true;
+#endif
+    return platform_is_dir(path);
+}
+
+bool platform_replace_file(const char *from, const char *to)
+{
+#if defined(_WIN32)
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(from, to) == 0;
+#endif
+}
+
+int platform_list_dir(const char *dir, platform_dir_fn fn, void *user)
+{
+    char path[1024];
+    int count = 0;
+
+#if defined(_WIN32)
+    struct _finddata_t fileinfo;
+    snprintf(path, sizeof(path), "%s/*", dir);
+    intptr_t handle = _findfirst(path, &fileinfo);
+    if (handle == -1) return -1;
+    do {
+        if (fileinfo.attrib & _A_SUBDIR) continue;
+        snprintf(path, sizeof(path), "%s/%s", dir, fileinfo.name);
+        fn(path, user);
+        count++;
+    } while (_findnext(handle, &fileinfo) == 0);
+    _findclose(handle);
+#else
+    DIR *d = opendir(dir);
+    if (!d) return -1;
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+        struct stat st;
+        if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) continue;
+        fn(path, user);
+        count++;
+    }
+    closedir(d);
+#endif
+    return count;
+}
+
+#if defined(_WIN32)
+
+bool platform_map_file(const char *path, platform_file_map_t *map)
+{
+    map->data = NULL;
+    map->size = 0;
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || (unsigned long long)size.QuadPart > (size_t)-1) {
+        CloseHandle(file);
+        return false;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        map->data = "";
+        return true;
+    }
+
+    /* The view keeps the file open; both handles can go once it exists */
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (mapping) CloseHandle(mapping);
+    CloseHandle(file);
+    if (!view) return false;
+
+    map->data = (const char *)view;
+    map->size = (size_t)size.QuadPart;
+    return true;
+}
+
+void platform_unmap_file(platform_file_map_t *map)
+{
+    if (map->data && map->size > 0) UnmapViewOfFile(map->data);
+    map->data = NULL;
+    map->size = 0;
+}
+
+#else
+
+bool platform_map_file(const char *path, platform_file_map_t *map)
+{
+    map->data = NULL;
+    map->size = 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return false;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        map->data = "";
+        return true;
+    }
+
+    void *view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) return false;
+    madvise(view, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    map->data = (const char *)view;
+    map->size = (size_t)st.st_size;
+    return true;
+}
+
+void platform_unmap_file(platform_file_map_t *map)
+{
+    if (map->data && map->size > 0) munmap((void *)map->data, map->size);
+    map->data = NULL;
+    map->size = 0;
+}
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * points.c - Growable Point Lists Implementation
+ */
+
+#include "points.h"
+#include <math.h>
+
+#define POINT_LIST_MIN_CAPACITY  256
+
+void point_list_init(point_list_t *list, mem_arena_t *arena)
+{
+    list->data = NULL;
+    list->count = 0;
+    list->capacity = 0;
+    list->arena = arena;
+}
+
+bool point_list_reserve(point_list_t *list, int capacity)
+{
+    if (capacity <= list->capacity) return true;
+
+    int new_capacity = list->capacity ? list->capacity : POINT_LIST_MIN_CAPACITY;
+    while (new_capacity < capacity) {
+        if (new_capacity > (1 << 29)) return false;
+        new_capacity *= 2;
+    }
+
+    size_t old_size = sizeof(Vector2) * (size_t)list->capacity;
+    size_t new_size = sizeof(Vector2) * (size_t)new_capacity;
+    Vector2 *data = list->arena
+        ? (Vector2 *)mem_arena_grow(list->arena, list->data, old_size, new_size)
+        : (Vector2 *)mem_realloc(list->data, new_size);
+    if (!data) return false;
+
+    list->data = data;
+    list->capacity = new_capacity;
+    return true;
+}
+
+bool point_list_push(point_list_t *list, Vector2 p)
+{
+    if (list->count == list->capacity && !point_list_reserve(list, list->count + 1)) return false;
+    list->data[list->count++] = p;
+    return true;
+}
+
+void point_list_clear(point_list_t *list)
+{
+    list->count = 0;
+}
+
+void point_list_free(point_list_t *list)
+{
+    if (!list->arena) mem_free(list->data);
+    point_list_init(list, list->arena);
+}
+
+bool point_list_resample(const point_list_t *src, point_list_t *dst, int m)
+{
+    int n = src->count;
+    if (n <= 0 || m <= 0 || !point_list_reserve(dst, m)) return false;
+
+    /* Perimeter, closing edge included (double: long paths of short edges) */
+    double perimeter = 0.0;
+    for (int i = 0; i < n; i++) {
+        Vector2 a = src->data[i];
+        Vector2 b = src->data[i + 1 < n ? i + 1 : 0];
+        perimeter += sqrt((double)(b.x - a.x) * (b.x - a.x) + (double)(b.y - a.y) * (b.y - a.y));
+    }
+
+    Vector2 *out = dst->data;
+    dst->count = m;
+    if (perimeter <= 0.0) {
+        for (int j = 0; j < m; j++) out[j] = src->data[0];
+        return true;
+    }
+
+    /* One pass: the edge cursor only moves forward as the target distance grows */
+    double spacing = perimeter / m;
+    double edge_start = 0.0;    /* Arc length at the start of edge i */
+    double edge_length = 0.0;
+    int i = -1;
+    for (int j = 0; j < m; j++) {
+        double target = j * spacing;
+        while (edge_start + edge_length <= target && i < n - 1) {
+            edge_start += edge_length;
+            i++;
+            Vector2 a = src->data[i];
+            Vector2 b = src->data[i + 1 < n ? i + 1 : 0];
+            edge_length = sqrt((double)(b.x - a.x) * (b.x - a.x) + (double)(b.y - a.y) * (b.y - a.y));
+        }
+
+        Vector2 a = src->data[i];
+        Vector2 b = src->data[i + 1 < n ? i + 1 : 0];
+        float f = edge_length > 0.0 ? (float)((target - edge_start) / edge_length) : 0.0f;
+        if (f > 1.0f) f = 1.0f;
+        out[j].x = a.x + (b.x - a.x) * f;
+        out[j].y = a.y + (b.y - a.y) * f;
+    }
+    return true;
+}
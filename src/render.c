@@ -0,0 +1,424 @@
+/**
+ * render.c - Epicycle Rendering Implementation
+ *
+ * All circles, arms and the tip dot are written as triangles into one
+ * CPU-side vertex buffer per frame, then submitted in a single
+ * rlBegin(RL_TRIANGLES)/rlEnd() run. Circles are built from a unit-circle
+ * template computed once, scaled and translated per term, so nothing is
+ * re-tessellated with cosf/sinf per frame.
+ *
+ * The finished part of the trace, the input path and the panel chrome live
+ * in offscreen render textures (layers). A layer is only rasterized again
+ * when its content changes: the input and trace layers append new segments,
+ * and everything is redrawn on load, reset or a style change. Each frame
+ * the layers are just blitted.
+ */
+
+#include "render.h"
+#include "ui.h"
+#include "mem.h"
+
+/* ========== rlgl Entry Points ========== */
+
+/* rlgl.h is not shipped in includes/; these are exported by raylib.dll */
+#define RL_TRIANGLES  0x0004
+RLAPI void rlBegin(int mode);
+RLAPI void rlEnd(void);
+RLAPI void rlVertex2f(float x, float y);
+RLAPI void rlColor4ub(unsigned char r, unsigned char g, unsigned char b, unsigned char a);
+RLAPI bool rlCheckRenderBatchLimit(int vCount);
+
+/* ========== Configuration ========== */
+
+#define CIRCLE_SEGMENTS         36      /* Same tessellation as DrawCircleLines() */
+#define CIRCLE_SEGMENTS_SMALL   12      /* Circles below CIRCLE_SMALL_RADIUS */
+#define CIRCLE_SMALL_RADIUS     12.0f
+#define CIRCLE_LINE_WIDTH       1.0f
+
+/* raylib's default batch holds 8192 quads (32768 vertices); stay a multiple of 3 below it */
+#define BATCH_MAX_VERTICES      32766
+
+/* Worst case per term: circle outline (2 triangles per segment) + arm quad */
+#define VERTICES_PER_TERM       (CIRCLE_SEGMENTS * 6 + 6)
+
+/* Room around the panel for the border, which straddles the rectangle edge */
+#define PANEL_LAYER_MARGIN      2
+#define PANEL_TITLE_HEIGHT      30
+
+/* ========== Types ========== */
+
+typedef struct {
+    float x, y;
+    Color color;
+} render_vertex_t;
+
+/* Offscreen render texture that is only redrawn when its content changes */
+typedef struct {
+    RenderTexture2D target;
+    bool loaded;
+    int drawn;          /* Points already rendered (input/trace) or panel height; -1 = stale */
+} layer_t;
+
+/* ========== State ========== */
+
+static Vector2 unit_circle[CIRCLE_SEGMENTS + 1];
+static bool unit_circle_ready = false;
+
+static render_vertex_t *vertices = NULL;
+static int vertex_capacity = 0;
+static int vertex_count = 0;
+
+static render_stats_t last_stats;
+
+/* Layers */
+static layer_t input_layer;
+static layer_t trace_layer;
+static layer_t panel_fill_layer;
+static layer_t panel_chrome_layer;
+static Color trace_color;
+static float trace_thickness;
+
+/* ========== Geometry ========== */
+
+static void build_unit_circle(void)
+{
+    for (int i = 0; i <= CIRCLE_SEGMENTS; i++) {
+        float angle = (2 * PI * (i % CIRCLE_SEGMENTS)) / CIRCLE_SEGMENTS;
+        unit_circle[i] = (Vector2){ cosf(angle), sinf(angle) };
+    }
+    unit_circle_ready = true;
+}
+
+/* raylib culls clockwise triangles; flip the winding when needed */
+static void push_triangle(Vector2 a, Vector2 b, Vector2 c, Color color)
+{
+    float cross = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (cross > 0) { Vector2 t = b; b = c; c = t; }
+
+    render_vertex_t *v = &vertices[vertex_count];
+    v[0] = (render_vertex_t){ a.x, a.y, color };
+    v[1] = (render_vertex_t){ b.x, b.y, color };
+    v[2] = (render_vertex_t){ c.x, c.y, color };
+    vertex_count += 3;
+}
+
+static void push_quad(Vector2 a, Vector2 b, Vector2 c, Vector2 d, Color color)
+{
+    push_triangle(a, b, c, color);
+    push_triangle(a, c, d, color);
+}
+
+/* Circle outline: one thin quad per template segment */
+static void push_circle_lines(float cx, float cy, float radius, Color color)
+{
+    int stride = radius < CIRCLE_SMALL_RADIUS ? CIRCLE_SEGMENTS / CIRCLE_SEGMENTS_SMALL : 1;
+    float r_in = radius - 0.5f * CIRCLE_LINE_WIDTH;
+    float r_out = radius + 0.5f * CIRCLE_LINE_WIDTH;
+
+    for (int i = 0; i < CIRCLE_SEGMENTS; i += stride) {
+        Vector2 u0 = unit_circle[i];
+        Vector2 u1 = unit_circle[i + stride];
+        push_quad((Vector2){ cx + u0.x * r_in,  cy + u0.y * r_in },
+                  (Vector2){ cx + u0.x * r_out, cy + u0.y * r_out },
+                  (Vector2){ cx + u1.x * r_out, cy + u1.y * r_out },
+                  (Vector2){ cx + u1.x * r_in,  cy + u1.y * r_in }, color);
+    }
+}
+
+/* Filled disc: triangle fan around the center */
+static void push_circle(float cx, float cy, float radius, Color color)
+{
+    Vector2 center = { cx, cy };
+    for (int i = 0; i < CIRCLE_SEGMENTS; i++) {
+        Vector2 u0 = unit_circle[i];
+        Vector2 u1 = unit_circle[i + 1];
+        push_triangle(center,
+                      (Vector2){ cx + u0.x * radius, cy + u0.y * radius },
+                      (Vector2){ cx + u1.x * radius, cy + u1.y * radius }, color);
+    }
+}
+
+/* Thick segment, same shape as DrawLineEx() */
+static void push_line(Vector2 a, Vector2 b, float thickness, Color color)
+{
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    float length = sqrtf(dx * dx + dy * dy);
+    if (length <= 0.0f) return;
+
+    float scale = 0.5f * thickness / length;
+    float nx = -dy * scale;
+    float ny = dx * scale;
+    push_quad((Vector2){ a.x + nx, a.y + ny }, (Vector2){ a.x - nx, a.y - ny },
+              (Vector2){ b.x - nx, b.y - ny }, (Vector2){ b.x + nx, b.y + ny }, color);
+}
+
+/* ========== Submission ========== */
+
+/* Hand the vertex buffer to rlgl; every flush of raylib's batch is one draw call */
+static int submit_vertices(void)
+{
+    int batches = 0;
+    for (int start = 0; start < vertex_count; start += BATCH_MAX_VERTICES) {
+        int count = vertex_count - start;
+        if (count > BATCH_MAX_VERTICES) count = BATCH_MAX_VERTICES;
+
+        rlCheckRenderBatchLimit(count);
+        rlBegin(RL_TRIANGLES);
+        const render_vertex_t *v = &vertices[start];
+        for (int i = 0; i < count; i++) {
+            rlColor4ub(v[i].color.r, v[i].color.g, v[i].color.b, v[i].color.a);
+            rlVertex2f(v[i].x, v[i].y);
+        }
+        rlEnd();
+        batches++;
+    }
+    return batches;
+}
+
+/* ========== Public API ========== */
+
+Vector2 draw_epicycles(const epicycle_eval_t *ev, float line_thickness, float alpha)
+{
+    if (!unit_circle_ready) build_unit_circle();
+
+    float x = 0;
+    float y = 0;
+
+    /* Capacity for the worst case, reused across frames */
+    int needed = ev->count * VERTICES_PER_TERM + CIRCLE_SEGMENTS * 3;
+    if (!mem_reserve((void **)&vertices, &vertex_capacity, needed, sizeof(render_vertex_t))) {
+        return (Vector2){ 0, 0 };
+    }
+    vertex_count = 0;
+    int circles = 0;
+
+    for (int k = 0; k < ev->count; k++)
+    {
+        float prev_x = x;
+        float prev_y = y;
+
+        /* Blend each arm toward its next step: arm + alpha * (arm * rot - arm) */
+        float ax = ev->arm_x[k];
+        float ay = ev->arm_y[k];
+        x += ax + alpha * (ax * ev->rot_x[k] - ay * ev->rot_y[k] - ax);
+        y += ay + alpha * (ax * ev->rot_y[k] + ay * ev->rot_x[k] - ay);
+
+        /* Only draw circles if amplitude is significant enough to see */
+        if (ev->amplitude[k] > 1.0f) {
+            /* Color gradient based on index */
+            unsigned char r = (unsigned char)(50 + ((k * 205) % 206));
+            unsigned char g = (unsigned char)(100 + ((k * 50) % 156));
+            unsigned char b = (unsigned char)(200 - ((k * 100) % 151));
+
+            /* The circle for this epicycle */
+            push_circle_lines(prev_x, prev_y, ev->amplitude[k], (Color){r, g, b, 80});
+
+            /* Line from center to point on circle (the arm) */
+            push_line((Vector2){prev_x, prev_y}, (Vector2){x, y}, line_thickness, (Color){r, g, b, 180});
+            circles++;
+        }
+    }
+
+    /* Final tip position - THIS is where the line is drawn from */
+    push_circle(x, y, 4.0f * line_thickness, (Color){255, 100, 100, 255});
+
+    last_stats.vertices = vertex_count;
+    last_stats.triangles = vertex_count / 3;
+    last_stats.circles = circles;
+    last_stats.batches = submit_vertices();
+
+    return (Vector2){ x, y };
+}
+
+/* ========== Layers ========== */
+
+static void layer_load(layer_t *layer, int width, int height)
+{
+    if (layer->loaded) return;
+    layer->target = LoadRenderTexture(width, height);
+    layer->loaded = true;
+    layer->drawn = -1;
+}
+
+static void layer_unload(layer_t *layer)
+{
+    if (!layer->loaded) return;
+    UnloadRenderTexture(layer->target);
+    layer->loaded = false;
+}
+
+/* Render textures are stored bottom-up */
+static void layer_blit(const layer_t *layer, Vector2 position, Color tint)
+{
+    if (!layer->loaded) return;
+    Rectangle source = { 0, 0, (float)layer->target.texture.width, -(float)layer->target.texture.height };
+    DrawTextureRec(layer->target.texture, source, position, tint);
+}
+
+void render_invalidate(int layers)
+{
+    if (layers & RENDER_LAYER_INPUT) input_layer.drawn = -1;
+    if (layers & RENDER_LAYER_TRACE) trace_layer.drawn = -1;
+    if (layers & RENDER_LAYER_PANEL) {
+        panel_fill_layer.drawn = -1;
+        panel_chrome_layer.drawn = -1;
+    }
+}
+
+/* ========== Input Layer ========== */
+
+void input_layer_update(const point_list_t *points)
+{
+    layer_load(&input_layer, WINDOW_WIDTH, WINDOW_HEIGHT);
+
+    /* Points are only appended while drawing; anything else is a new path */
+    bool redraw = input_layer.drawn < 0 || points->count < input_layer.drawn;
+    int first = redraw ? 0 : (input_layer.drawn > 0 ? input_layer.drawn - 1 : 0);
+    if (!redraw && points->count - 1 - first <= 0) return;
+
+    BeginTextureMode(input_layer.target);
+    if (redraw) ClearBackground(BLANK);
+    for (int i = first; i < points->count - 1; i++) {
+        DrawLine((int)points->data[i].x, (int)points->data[i].y,
+                 (int)points->data[i + 1].x, (int)points->data[i + 1].y, WHITE);
+    }
+    EndTextureMode();
+
+    input_layer.drawn = points->count;
+    if (redraw) last_stats.layer_redraws++;
+}
+
+void input_layer_draw(void)
+{
+    layer_blit(&input_layer, (Vector2){ 0, 0 }, WHITE);
+}
+
+/* ========== Trace Layer ========== */
+
+/* Fixed per-segment shade: darker at the start, full color at the end of the cycle */
+static Color trace_segment_color(Color base, int i, int total_steps)
+{
+    float alpha = (float)i / (total_steps > 1 ? total_steps : 1);
+    if (alpha > 1.0f) alpha = 1.0f;
+    return (Color){
+        (unsigned char)(base.r * (0.3f + 0.7f * alpha)),
+        (unsigned char)(base.g * (0.3f + 0.7f * alpha)),
+        (unsigned char)(base.b * (0.3f + 0.7f * alpha)),
+        255
+    };
+}
+
+static bool same_color(Color a, Color b)
+{
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+void trace_layer_update(const point_list_t *trace, int total_steps, Color base, float thickness)
+{
+    layer_load(&trace_layer, WINDOW_WIDTH, WINDOW_HEIGHT);
+
+    /* Style change or a shorter trace (restart) invalidates what is already drawn */
+    bool redraw = trace_layer.drawn < 0 || trace->count < trace_layer.drawn ||
+                  !same_color(base, trace_color) || thickness != trace_thickness;
+    int first = redraw ? 0 : (trace_layer.drawn > 0 ? trace_layer.drawn - 1 : 0);
+    int segments = trace->count - 1 - first;
+
+    last_stats.trace_segments = segments > 0 ? segments : 0;
+    last_stats.trace_redraw = redraw;
+    if (!redraw && segments <= 0) return;
+
+    BeginTextureMode(trace_layer.target);
+    if (redraw) ClearBackground(BLANK);
+    for (int i = first; i < trace->count - 1; i++) {
+        DrawLineEx(trace->data[i], trace->data[i + 1], thickness,
+                   trace_segment_color(base, i, total_steps));
+    }
+    EndTextureMode();
+
+    trace_layer.drawn = trace->count;
+    trace_color = base;
+    trace_thickness = thickness;
+    if (redraw) last_stats.layer_redraws++;
+}
+
+void trace_layer_draw(void)
+{
+    layer_blit(&trace_layer, (Vector2){ 0, 0 }, WHITE);
+}
+
+/* ========== Panel Layer ========== */
+
+/*
+ * The panel background is translucent. Drawing it translucent into a
+ * cleared texture and blending that again would square its alpha, so the
+ * fill is rasterized opaque into its own texture and gets its alpha from
+ * the blit tint. Border, title and separator are opaque and sit in a
+ * second texture composited on top.
+ */
+void panel_layer_draw(Rectangle rect, const char *title)
+{
+    int width = (int)rect.width + 2 * PANEL_LAYER_MARGIN;
+    int height = WINDOW_HEIGHT;
+    layer_load(&panel_fill_layer, width, height);
+    layer_load(&panel_chrome_layer, width, height);
+
+    Color fill = COLOR_PANEL_BG;
+    Color fill_tint = (Color){ 255, 255, 255, fill.a };
+    fill.a = 255;
+
+    /* Draw in window coordinates, shifted into the texture */
+    Camera2D camera = { 0 };
+    camera.offset = (Vector2){ PANEL_LAYER_MARGIN - rect.x, PANEL_LAYER_MARGIN - rect.y };
+    camera.zoom = 1.0f;
+
+    int key = (int)rect.height;
+    if (panel_fill_layer.drawn != key) {
+        BeginTextureMode(panel_fill_layer.target);
+        ClearBackground(BLANK);
+        BeginMode2D(camera);
+        DrawRectangleRounded(rect, 0.05f, 8, fill);
+        EndMode2D();
+        EndTextureMode();
+        panel_fill_layer.drawn = key;
+        last_stats.layer_redraws++;
+    }
+
+    if (panel_chrome_layer.drawn != key) {
+        int y_pos = (int)rect.y + PANEL_PADDING;
+        BeginTextureMode(panel_chrome_layer.target);
+        ClearBackground(BLANK);
+        BeginMode2D(camera);
+        DrawRectangleRoundedLines(rect, 0.05f, 8, COLOR_PANEL_BORDER);
+        DrawText(title, (int)rect.x + PANEL_PADDING, y_pos, 20, COLOR_ACCENT);
+        draw_panel_separator(y_pos + PANEL_TITLE_HEIGHT);
+        EndMode2D();
+        EndTextureMode();
+        panel_chrome_layer.drawn = key;
+        last_stats.layer_redraws++;
+    }
+
+    Vector2 origin = { rect.x - PANEL_LAYER_MARGIN, rect.y - PANEL_LAYER_MARGIN };
+    layer_blit(&panel_fill_layer, origin, fill_tint);
+    layer_blit(&panel_chrome_layer, origin, WHITE);
+}
+
+/* ========== Stats / Shutdown ========== */
+
+render_stats_t render_last_stats(void)
+{
+    return last_stats;
+}
+
+void render_shutdown(void)
+{
+    mem_free(vertices);
+    vertices = NULL;
+    vertex_capacity = 0;
+    vertex_count = 0;
+
+    layer_unload(&input_layer);
+    layer_unload(&trace_layer);
+    layer_unload(&panel_fill_layer);
+    layer_unload(&panel_chrome_layer);
+}
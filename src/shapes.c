@@ -1,10 +1,28 @@
 #define _CRT_SECURE_NO_WARNINGS
 #include "shapes.h"
+#include "mem.h"
+#include "platform.h"
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
+static bool shapes_verbose = true;
+static float flatten_tolerance = SVG_FLATTEN_TOLERANCE;
+
+void shapes_set_verbose(bool verbose) {
+    shapes_verbose = verbose;
+}
+
+void shapes_set_flatten_tolerance(float pixels) {
+    flatten_tolerance = pixels;
+}
+
+float shapes_flatten_tolerance(void) {
+    return flatten_tolerance;
+}
+
 #ifndef PI
 #define PI 3.14159265358979323846f
 #endif
@@ -110,6 +128,178 @@ int generate_spiral(Vector2 *points, float cx, float cy, float max_radius, int n
     return num_points;
 }
 
+/* Axis-aligned bounds of a run of points */
+typedef struct {
+    float min_x, min_y, max_x, max_y;
+} bounds_t;
+
+static void bounds_add(bounds_t *b, Vector2 q) {
+    if (q.x < b->min_x) b->min_x = q.x;
+    if (q.x > b->max_x) b->max_x = q.x;
+    if (q.y < b->min_y) b->min_y = q.y;
+    if (q.y > b->max_y) b->max_y = q.y;
+}
+
+/* Bounds of points[first..] (at least one point) */
+static bounds_t point_bounds(const point_list_t *points, int first) {
+    bounds_t b = { points->data[first].x, points->data[first].y, points->data[first].x, points->data[first].y };
+    for (int i = first + 1; i < points->count; i++) bounds_add(&b, points->data[i]);
+    return b;
+}
+
+/* Center points[first..], whose bounds are b, on (cx, cy) and scale the larger side to `scale` */
+static void fit_to_bounds(point_list_t *points, int first, const bounds_t *b, float cx, float cy, float scale) {
+    Vector2 *pts = points->data + first;
+    int count = points->count - first;
+    
+    float orig_cx = (b->min_x + b->max_x) / 2.0f;
+    float orig_cy = (b->min_y + b->max_y) / 2.0f;
+    float width = b->max_x - b->min_x;
+    float height = b->max_y - b->min_y;
+    float max_dim = (width > height) ? width : height;
+    float s = (max_dim > 0) ? (scale / max_dim) : 1.0f;
+    
+    for (int i = 0; i < count; i++) {
+        pts[i].x = cx + (pts[i].x - orig_cx) * s;
+        pts[i].y = cy + (pts[i].y - orig_cy) * s;
+    }
+}
+
+/* Center points[first..] on (cx, cy) and scale the larger side to `scale` */
+static void fit_points(point_list_t *points, int first, float cx, float cy, float scale) {
+    bounds_t b = point_bounds(points, first);
+    fit_to_bounds(points, first, &b, cx, cy, scale);
+}
+
+/* ========== NUMBER SCANNER ========== */
+
+/*
+ * Decimal digits are gathered into an exact 64-bit mantissa with a power-of-
+ * ten exponent; the common case (at most 2^53 and |exponent| <= 22) is then a
+ * single exactly rounded double multiply or divide, since both operands are
+ * exact. No locale is consulted, and nothing past `end` is read.
+ */
+
+/* Significant digits kept; later ones only move the exponent */
+#define SCAN_MAX_DIGITS  19
+
+/* Powers of ten that are exact in a double */
+static const double exact_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* SWAR: are all 8 bytes of v (little-endian load) ASCII digits? */
+static bool is_eight_digits(uint64_t v) {
+    return ((v & 0xF0F0F0F0F0F0F0F0ull) |
+            (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+}
+
+/* SWAR: value of 8 ASCII digits in 3 multiplies (pairs, then quads, then the whole word) */
+static uint32_t eight_digits_value(uint64_t v) {
+    const uint64_t mask = 0x000000FF000000FFull;
+    const uint64_t mul1 = 0x000F424000000064ull;   /* 100 + (1000000 << 32) */
+    const uint64_t mul2 = 0x0000271000000001ull;   /* 1 + (10000 << 32) */
+    v -= 0x3030303030303030ull;
+    v = (v * 10) + (v >> 8);
+    v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+    return (uint32_t)v;
+}
+
+/* Add a run of digits to the mantissa; fraction digits that are kept lower the exponent,
+ * integer digits that are dropped raise it */
+static const char *scan_digits(const char *p, const char *end, bool fraction,
+                               uint64_t *mantissa, int *digits, int *exp10) {
+    uint64_t m = *mantissa;
+    int n = *digits;
+    int e = *exp10;
+    
+    /* Eight at a time while they all fit (long fractions from Inkscape & co.) */
+    while (end - p >= 8 && n + 8 <= SCAN_MAX_DIGITS) {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        if (!is_eight_digits(v)) break;
+        m = m * 100000000u + eight_digits_value(v);
+        if (m != 0) n += 8;
+        if (fraction) e -= 8;
+        p += 8;
+    }
+    for (; p < end && (unsigned)(*p - '0') < 10u; p++) {
+        if (n < SCAN_MAX_DIGITS) {
+            m = m * 10 + (unsigned)(*p - '0');
+            if (m != 0) n++;         /* Leading zeros are not significant */
+            if (fraction) e--;
+        } else if (!fraction) {
+            e++;
+        }
+    }
+    
+    *mantissa = m;
+    *digits = n;
+    *exp10 = e;
+    return p;
+}
+
+const char *scan_float(const char *p, const char *end, float *out) {
+    const char *start = p;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = *p == '-';
+        p++;
+    }
+    
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exp10 = 0;
+    const char *int_start = p;
+    p = scan_digits(p, end, false, &mantissa, &digits, &exp10);
+    bool any = p > int_start;
+    
+    /* One '.' at most: "1.5.5" is 1.5 followed by .5 */
+    if (p < end && *p == '.') {
+        const char *frac_start = p + 1;
+        const char *frac_end = scan_digits(frac_start, end, true, &mantissa, &digits, &exp10);
+        if (any || frac_end > frac_start) {
+            any = true;
+            p = frac_end;
+        }
+    }
+    if (!any) {
+        *out = 0.0f;
+        return start;
+    }
+    
+    /* The exponent only counts with digits after it ("1e" is 1 followed by a command) */
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char *q = p + 1;
+        bool exp_negative = false;
+        if (q < end && (*q == '+' || *q == '-')) {
+            exp_negative = *q == '-';
+            q++;
+        }
+        if (q < end && (unsigned)(*q - '0') < 10u) {
+            int e = 0;
+            for (; q < end && (unsigned)(*q - '0') < 10u; q++) {
+                if (e < 10000) e = e * 10 + (*q - '0');
+            }
+            exp10 += exp_negative ? -e : e;
+            p = q;
+        }
+    }
+    
+    double value;
+    if (mantissa == 0) {
+        value = 0.0;
+    } else if (mantissa <= (1ull << 53) && exp10 >= -22 && exp10 <= 22) {
+        value = exp10 < 0 ? (double)mantissa / exact_pow10[-exp10] : (double)mantissa * exact_pow10[exp10];
+    } else {
+        /* Rare (over 16 digits or a large exponent): within a double ulp, far below float precision */
+        value = (double)mantissa * pow(10.0, exp10);
+    }
+    *out = (float)(negative ? -value : value);
+    return p;
+}
+
 /* Load shape from a text file
  * File format: one "x y" coordinate per line
  * Example:
@@ -118,389 +308,897 @@ int generate_spiral(Vector2 *points, float cx, float cy, float max_radius, int n
  *   110 60
  * Points are centered and scaled to fit around (cx, cy)
  */
-int load_shape_from_file(Vector2 *points, const char *filename, float cx, float cy, float scale, int max_points) {
-    FILE *file = fopen(filename, "r");
-    if (!file) {
-        printf("Could not open shape file: %s\n", filename);
+/* Helper: skip blanks within a line */
+static const char *skip_blank(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f')) p++;
+    return p;
+}
+
+int load_shape_from_file(point_list_t *points, const char *filename, float cx, float cy, float scale) {
+    platform_file_map_t map;
+    if (!platform_map_file(filename, &map)) {
+        fprintf(stderr, "Could not open shape file: %s\n", filename);
         return 0;
     }
     
-    /* First pass: read points and find bounding box */
-    float temp_x[5000], temp_y[5000];
-    int count = 0;
-    float min_x = 1e9f, max_x = -1e9f;
-    float min_y = 1e9f, max_y = -1e9f;
-    
-    char line[256];
-    while (fgets(line, sizeof(line), file) && count < max_points && count < 5000) {
+    /* First pass: read raw points into the output list. A line counts when it starts
+     * with two numbers (blanks around them optional, as with sscanf "%f %f"); anything
+     * after them, and lines that do not (comments), are ignored. */
+    int first = points->count;
+    const char *p = map.data;
+    const char *end = map.data + map.size;
+    while (p < end) {
+        const char *line_end = (const char *)memchr(p, '\n', (size_t)(end - p));
+        if (!line_end) line_end = end;
+        
         float x, y;
-        if (sscanf(line, "%f %f", &x, &y) == 2) {
-            temp_x[count] = x;
-            temp_y[count] = y;
-            if (x < min_x) min_x = x;
-            if (x > max_x) max_x = x;
-            if (y < min_y) min_y = y;
-            if (y > max_y) max_y = y;
-            count++;
+        const char *q = skip_blank(p, line_end);
+        const char *r = scan_float(q, line_end, &x);
+        if (r > q) {
+            q = skip_blank(r, line_end);
+            r = scan_float(q, line_end, &y);
+            if (r > q && !point_list_push(points, (Vector2){ x, y })) break;
         }
+        p = line_end + 1;
     }
-    fclose(file);
+    platform_unmap_file(&map);
     
+    int count = points->count - first;
     if (count == 0) return 0;
     
-    /* Calculate center and size of original shape */
-    float orig_cx = (min_x + max_x) / 2.0f;
-    float orig_cy = (min_y + max_y) / 2.0f;
-    float width = max_x - min_x;
-    float height = max_y - min_y;
-    float max_dim = (width > height) ? width : height;
-    
-    /* Scale factor to fit shape to desired size */
-    float s = (max_dim > 0) ? (scale / max_dim) : 1.0f;
-    
-    /* Second pass: center and scale points */
-    for (int i = 0; i < count; i++) {
-        points[i].x = cx + (temp_x[i] - orig_cx) * s;
-        points[i].y = cy + (temp_y[i] - orig_cy) * s;
-    }
+    /* Second pass: center and scale points in place */
+    fit_points(points, first, cx, cy, scale);
     
-    printf("Loaded %d points from %s\n", count, filename);
+    if (shapes_verbose) fprintf(stderr, "Loaded %d points from %s\n", count, filename);
     return count;
 }
 
 /* ========== SVG PATH PARSER ========== */
 
+/* Path data is parsed in place (e.g. straight out of a mapped file), so every scan stops at `end` */
+
 /* Helper: skip whitespace and commas */
-static const char *skip_ws(const char *p) {
-    while (*p && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r' || *p == ',')) p++;
+static const char *skip_ws(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r' || *p == ',')) p++;
     return p;
 }
 
-/* Helper: parse a float number from string */
-static const char *parse_float(const char *p, float *out) {
-    p = skip_ws(p);
-    char *end;
-    *out = strtof(p, &end);
-    return end;
+
+static const svg_matrix_t identity_matrix = { 1, 0, 0, 1, 0, 0 };
+
+/* Helper: map a point from user space to document space */
+static Vector2 apply_matrix(const svg_matrix_t *m, float x, float y) {
+    return (Vector2){ m->a * x + m->c * y + m->e, m->b * x + m->d * y + m->f };
 }
 
-/* Helper: add point to array with bounds checking */
-static int add_point(float *tx, float *ty, int *count, float x, float y, int max) {
-    if (*count < max) {
-        tx[*count] = x;
-        ty[*count] = y;
-        (*count)++;
-        return 1;
+/* ========== Curve Flattening ========== */
+
+/*
+ * How finely a curve must be split depends on the size the path is shown
+ * at, which is only known once the whole path has been read. So the parser
+ * emits each curve's end point and records the curve; flatten_curves() then
+ * picks a chord count per curve and opens up room for the interior points
+ * in place, working back to front.
+ */
+typedef struct {
+    int index;          /* Position of the curve's end point in the output */
+    int degree;         /* 2 = quadratic, 3 = cubic */
+    int segments;       /* Chords, set by flatten_curves() */
+    Vector2 p[4];       /* Control points, p[0] = start */
+} svg_curve_t;
+
+typedef struct {
+    svg_curve_t *data;
+    int count;
+    int capacity;
+    int hint;           /* First capacity: enough for any path of this length */
+    mem_arena_t *arena; /* Same as the output list's: NULL = heap */
+} curve_list_t;
+
+static bool curve_list_push(curve_list_t *list, const svg_curve_t *curve) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : list->hint;
+        size_t old_size = sizeof(svg_curve_t) * (size_t)list->capacity;
+        size_t new_size = sizeof(svg_curve_t) * (size_t)capacity;
+        svg_curve_t *data = list->arena
+            ? (svg_curve_t *)mem_arena_grow(list->arena, list->data, old_size, new_size)
+            : (svg_curve_t *)mem_realloc(list->data, new_size);
+        if (!data) return false;
+        list->data = data;
+        list->capacity = capacity;
     }
-    return 0;
+    list->data[list->count++] = *curve;
+    return true;
 }
 
-/* Helper: cubic bezier interpolation */
-static void cubic_bezier(float *tx, float *ty, int *count, int max,
+/*
+ * Where a path's segments go. Points and control points are mapped to
+ * document space as they are emitted, so transforms cost no pass of their
+ * own; curves are affine-invariant, so flattening the mapped control points
+ * gives the mapped curve.
+ */
+typedef struct {
+    point_list_t *out;
+    curve_list_t *curves;
+    svg_matrix_t m;         /* User space of the path to document space */
+} path_sink_t;
+
+/* Helper: append point to the output list */
+static void add_point(path_sink_t *sink, float x, float y) {
+    point_list_push(sink->out, apply_matrix(&sink->m, x, y));
+}
+
+/* Helper: cubic bezier (end point now, interior points by flatten_curves) */
+static void cubic_bezier(path_sink_t *sink,
                          float x0, float y0, float x1, float y1, 
-                         float x2, float y2, float x3, float y3, int steps) {
-    for (int i = 1; i <= steps; i++) {
-        float t = (float)i / steps;
-        float u = 1 - t;
-        float x = u*u*u*x0 + 3*u*u*t*x1 + 3*u*t*t*x2 + t*t*t*x3;
-        float y = u*u*u*y0 + 3*u*u*t*y1 + 3*u*t*t*y2 + t*t*t*y3;
-        add_point(tx, ty, count, x, y, max);
+                         float x2, float y2, float x3, float y3) {
+    const svg_matrix_t *m = &sink->m;
+    svg_curve_t curve = { sink->out->count, 3, 1,
+        { apply_matrix(m, x0, y0), apply_matrix(m, x1, y1), apply_matrix(m, x2, y2), apply_matrix(m, x3, y3) } };
+    point_list_push(sink->out, curve.p[3]);
+    if (sink->out->count > curve.index) curve_list_push(sink->curves, &curve);
+}
+
+/* Helper: quadratic bezier (end point now, interior points by flatten_curves) */
+static void quad_bezier(path_sink_t *sink,
+                        float x0, float y0, float x1, float y1, float x2, float y2) {
+    const svg_matrix_t *m = &sink->m;
+    svg_curve_t curve = { sink->out->count, 2, 1,
+        { apply_matrix(m, x0, y0), apply_matrix(m, x1, y1), apply_matrix(m, x2, y2), { 0, 0 } } };
+    curve.p[3] = curve.p[2];
+    point_list_push(sink->out, curve.p[2]);
+    if (sink->out->count > curve.index) curve_list_push(sink->curves, &curve);
+}
+
+/*
+ * Chords needed to stay within tol of the curve (Wang's formula): uniform
+ * steps of 1/n keep a degree-d curve within
+ *   d*(d-1)/8 * max|p[i] - 2*p[i+1] + p[i+2]| / n^2
+ * of its chords.
+ */
+static int curve_segments(const svg_curve_t *c, double tol) {
+    double m = 0.0;
+    for (int i = 0; i + 2 <= c->degree; i++) {
+        double dx = (double)c->p[i].x - 2.0 * c->p[i + 1].x + c->p[i + 2].x;
+        double dy = (double)c->p[i].y - 2.0 * c->p[i + 1].y + c->p[i + 2].y;
+        double len = sqrt(dx * dx + dy * dy);
+        if (len > m) m = len;
+    }
+    if (m <= 0.0) return 1;
+    if (tol <= 0.0) return SVG_FLATTEN_MAX_SEGMENTS;
+    
+    double n = ceil(sqrt(c->degree * (c->degree - 1) / 8.0 * m / tol));
+    return n < SVG_FLATTEN_MAX_SEGMENTS ? (n > 1.0 ? (int)n : 1) : SVG_FLATTEN_MAX_SEGMENTS;
+}
+
+/* Interior points t = 1/n .. (n-1)/n of a curve by forward differencing (no per-point polynomial) */
+static void curve_interior(const svg_curve_t *c, Vector2 *dst) {
+    int n = c->segments;
+    double h = 1.0 / n;
+    double px[4], py[4];
+    for (int i = 0; i < 4; i++) { px[i] = c->p[i].x; py[i] = c->p[i].y; }
+    
+    /* Power basis a*t^3 + b*t^2 + e*t + p0, then the first three differences at step h */
+    double ax, ay, bx, by, ex, ey;
+    if (c->degree == 3) {
+        ax = -px[0] + 3 * px[1] - 3 * px[2] + px[3];
+        ay = -py[0] + 3 * py[1] - 3 * py[2] + py[3];
+        bx = 3 * px[0] - 6 * px[1] + 3 * px[2];
+        by = 3 * py[0] - 6 * py[1] + 3 * py[2];
+        ex = 3 * (px[1] - px[0]);
+        ey = 3 * (py[1] - py[0]);
+    } else {
+        ax = ay = 0.0;
+        bx = px[0] - 2 * px[1] + px[2];
+        by = py[0] - 2 * py[1] + py[2];
+        ex = 2 * (px[1] - px[0]);
+        ey = 2 * (py[1] - py[0]);
+    }
+    double h2 = h * h, h3 = h2 * h;
+    double x = px[0], y = py[0];
+    double dx = ax * h3 + bx * h2 + ex * h, dy = ay * h3 + by * h2 + ey * h;
+    double ddx = 6 * ax * h3 + 2 * bx * h2, ddy = 6 * ay * h3 + 2 * by * h2;
+    double dddx = 6 * ax * h3, dddy = 6 * ay * h3;
+    
+    for (int i = 0; i < n - 1; i++) {
+        x += dx; y += dy;
+        dx += ddx; dy += ddy;
+        ddx += dddx; ddy += dddy;
+        dst[i].x = (float)x;
+        dst[i].y = (float)y;
     }
 }
 
-/* Helper: quadratic bezier interpolation */
-static void quad_bezier(float *tx, float *ty, int *count, int max,
-                        float x0, float y0, float x1, float y1, float x2, float y2, int steps) {
-    for (int i = 1; i <= steps; i++) {
-        float t = (float)i / steps;
-        float u = 1 - t;
-        float x = u*u*x0 + 2*u*t*x1 + t*t*x2;
-        float y = u*u*y0 + 2*u*t*y1 + t*t*y2;
-        add_point(tx, ty, count, x, y, max);
+/*
+ * Split the recorded curves of out[first..] into chords within tolerance *
+ * (path size) of the curve. The size is taken from the on-curve points,
+ * which never span more than the flattened path, so the tolerance holds
+ * after the path is fitted. Returns the bounds of the flattened points
+ * (interior points are added as they are made), so fitting the result
+ * needs no second scan.
+ */
+static bounds_t flatten_curves(point_list_t *out, int first, curve_list_t *curves, float tolerance) {
+    bounds_t b = point_bounds(out, first);
+    if (curves->count == 0) return b;
+    
+    double size = fmax((double)b.max_x - b.min_x, (double)b.max_y - b.min_y);
+    if (size <= 0.0) {
+        /* A single on-curve point: size the path by its control points instead */
+        for (int j = 0; j < curves->count; j++) {
+            for (int i = 0; i < 4; i++) {
+                size = fmax(size, fabs((double)curves->data[j].p[i].x - out->data[first].x));
+                size = fmax(size, fabs((double)curves->data[j].p[i].y - out->data[first].y));
+            }
+        }
+    }
+    double tol = tolerance * size;
+    
+    long long extra = 0;
+    for (int j = 0; j < curves->count; j++) {
+        curves->data[j].segments = curve_segments(&curves->data[j], tol);
+        extra += curves->data[j].segments - 1;
     }
+    if (extra == 0 || out->count + extra > (1 << 29) || !point_list_reserve(out, out->count + (int)extra)) return b;
+    
+    /* Back to front: move the points after each curve up, then fill the gap before its end point */
+    int r = out->count - 1;
+    int w = out->count + (int)extra - 1;
+    for (int j = curves->count - 1; j >= 0; j--) {
+        const svg_curve_t *c = &curves->data[j];
+        while (r >= c->index) out->data[w--] = out->data[r--];
+        w -= c->segments - 1;
+        curve_interior(c, &out->data[w + 1]);
+        for (int i = 1; i < c->segments; i++) bounds_add(&b, out->data[w + i]);
+    }
+    out->count += (int)extra;
+    return b;
 }
 
-/* Parse SVG path data string into points */
-static int parse_svg_path(const char *d, float *tx, float *ty, int max) {
-    int count = 0;
+/*
+ * Elliptical arc (SVG endpoint parameterization) as cubics of at most 90
+ * degrees each, which stay within about 3e-4 of the radius of the true arc.
+ * Out-of-range radii are scaled up and zero radii give a straight line, as
+ * the SVG implementation notes require.
+ */
+static void arc_to_curves(path_sink_t *sink, float x1, float y1,
+                          float rx_in, float ry_in, float angle, bool large_arc, bool sweep,
+                          float x2, float y2) {
+    if (x1 == x2 && y1 == y2) return;   /* Same end points: the arc is omitted */
+    double rx = fabs((double)rx_in), ry = fabs((double)ry_in);
+    if (rx == 0.0 || ry == 0.0) {
+        add_point(sink, x2, y2);
+        return;
+    }
+    
+    /* Center parameterization: start point in the ellipse's frame, centered between the end points */
+    double phi = angle * (3.14159265358979323846 / 180.0);
+    double cos_phi = cos(phi), sin_phi = sin(phi);
+    double hx = ((double)x1 - x2) / 2, hy = ((double)y1 - y2) / 2;
+    double px = cos_phi * hx + sin_phi * hy;
+    double py = -sin_phi * hx + cos_phi * hy;
+    
+    double lambda = (px * px) / (rx * rx) + (py * py) / (ry * ry);
+    if (lambda > 1.0) {
+        rx *= sqrt(lambda);
+        ry *= sqrt(lambda);
+    }
+    double num = rx * rx * ry * ry - rx * rx * py * py - ry * ry * px * px;
+    double den = rx * rx * py * py + ry * ry * px * px;
+    double coef = den > 0.0 && num > 0.0 ? sqrt(num / den) : 0.0;
+    if (large_arc == sweep) coef = -coef;
+    double ccx = coef * rx * py / ry;
+    double ccy = -coef * ry * px / rx;
+    double center_x = cos_phi * ccx - sin_phi * ccy + ((double)x1 + x2) / 2;
+    double center_y = sin_phi * ccx + cos_phi * ccy + ((double)y1 + y2) / 2;
+    
+    double theta = atan2((py - ccy) / ry, (px - ccx) / rx);
+    double delta = atan2((-py - ccy) / ry, (-px - ccx) / rx) - theta;
+    if (!sweep && delta > 0) delta -= 2 * 3.14159265358979323846;
+    if (sweep && delta < 0) delta += 2 * 3.14159265358979323846;
+    
+    int n = (int)ceil(fabs(delta) / (3.14159265358979323846 / 2) - 1e-9);
+    if (n < 1) n = 1;
+    double step = delta / n;
+    double k = 4.0 / 3.0 * tan(step / 4);
+    
+    /* Unit-circle cubic per step, scaled by the radii, rotated by phi and moved to the center */
+    float sx = x1, sy = y1;
+    double c0 = cos(theta), s0 = sin(theta);
+    for (int i = 1; i <= n; i++) {
+        double t = theta + step * i;
+        double c1 = cos(t), s1 = sin(t);
+        double ux[3] = { c0 - k * s0, c1 + k * s1, c1 };
+        double uy[3] = { s0 + k * c0, s1 - k * c1, s1 };
+        float q[6];
+        for (int j = 0; j < 3; j++) {
+            q[2 * j]     = (float)(center_x + cos_phi * rx * ux[j] - sin_phi * ry * uy[j]);
+            q[2 * j + 1] = (float)(center_y + sin_phi * rx * ux[j] + cos_phi * ry * uy[j]);
+        }
+        if (i == n) { q[4] = x2; q[5] = y2; }   /* Land exactly on the given end point */
+        cubic_bezier(sink, sx, sy, q[0], q[1], q[2], q[3], q[4], q[5]);
+        sx = q[4]; sy = q[5];
+        c0 = c1; s0 = s1;
+    }
+}
+
+/* Arguments per path command (index: letter - 'a'); -1 = not a command */
+static const signed char path_arg_count[26] = {
+    /* a  b   c   d   e   f   g   h   i   j   k   l   m   n   o   p   q   r   s   t   u   v   w   x   y   z */
+       7, -1, 6, -1, -1, -1, -1, 1, -1, -1, -1, 2, 2, -1, -1, -1, 4, -1, 4, 2, -1, 1, -1, -1, -1, 0
+};
+
+static const char *const path_error_names[] = {
+    "no error",
+    "unknown command",
+    "path data must start with a moveto",
+    "missing or malformed number",
+    "arc flag must be 0 or 1",
+};
+
+const char *svg_path_error_string(svg_path_error_t error) {
+    int i = (int)error;
+    int count = (int)(sizeof(path_error_names) / sizeof(path_error_names[0]));
+    return i >= 0 && i < count ? path_error_names[i] : "unknown error";
+}
+
+/*
+ * Parse path data d[0..length) into points (appended to out); curves are
+ * recorded for flatten_curves(). Each command reads its arguments (count
+ * from path_arg_count) into one array, then emits its segment; arguments
+ * without a command letter repeat the last command (after a moveto, as
+ * lineto). On an error the path keeps everything before the command in
+ * error and the rest is ignored, as SVG renderers do.
+ */
+static void parse_path_data(const char *d, int length, path_sink_t *sink, svg_path_status_t *status) {
     float cx = 0, cy = 0;  /* Current position */
     float sx = 0, sy = 0;  /* Start of subpath (for Z command) */
     float lx = 0, ly = 0;  /* Last control point (for smooth curves) */
-    char cmd = 0;
+    char cmd = 0;          /* Current command, lower case */
+    char prev = 0;         /* Previous command, lower case (smooth curves reflect only after their kind) */
+    bool relative = false;
+    int commands = 0;
+    svg_path_error_t error = SVG_PATH_OK;
     const char *p = d;
-    int bezier_steps = 10;
+    const char *end = d + length;
     
-    while (*p) {
-        p = skip_ws(p);
-        if (!*p) break;
+    while ((p = skip_ws(p, end)) < end) {
+        char ch = *p;
         
-        /* Check for command letter */
-        if ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z')) {
-            cmd = *p++;
+        /* Command letter, or arguments repeating the current command */
+        if ((ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z')) {
+            char lower = (char)(ch | 0x20);
+            if (path_arg_count[lower - 'a'] < 0) { error = SVG_PATH_BAD_COMMAND; break; }
+            if (commands == 0 && lower != 'm') { error = SVG_PATH_NO_MOVETO; break; }
+            cmd = lower;
+            relative = ch == lower;
+            p++;
+        } else if (cmd == 0) {
+            error = SVG_PATH_NO_MOVETO;
+            break;
+        } else if (cmd == 'z') {
+            error = SVG_PATH_BAD_COMMAND;   /* closepath takes no arguments */
+            break;
         }
         
-        p = skip_ws(p);
+        float a[7];
+        int argc = path_arg_count[cmd - 'a'];
+        for (int i = 0; i < argc; i++) {
+            const char *q = skip_ws(p, end);
+            if (cmd == 'a' && (i == 3 || i == 4)) {
+                /* Flags are a single digit and may run into the next number ("a1 1 0 114 5") */
+                if (q >= end || (*q != '0' && *q != '1')) { error = SVG_PATH_BAD_FLAG; p = q; break; }
+                a[i] = (float)(*q - '0');
+                p = q + 1;
+            } else {
+                p = scan_float(q, end, &a[i]);
+                if (p == q) { error = SVG_PATH_BAD_NUMBER; break; }
+            }
+        }
+        if (error != SVG_PATH_OK) break;
         
+        float ox = relative ? cx : 0.0f, oy = relative ? cy : 0.0f;
         switch (cmd) {
-            case 'M': { /* Move to (absolute) */
-                float x, y;
-                p = parse_float(p, &x);
-                p = parse_float(p, &y);
-                cx = x; cy = y;
+            case 'm':
+                cx = a[0] + ox; cy = a[1] + oy;
                 sx = cx; sy = cy;
-                add_point(tx, ty, &count, cx, cy, max);
-                cmd = 'L'; /* Subsequent coords are line-to */
+                add_point(sink, cx, cy);
+                cmd = 'l';  /* Further pairs are lineto, of the same kind */
                 break;
-            }
-            case 'm': { /* Move to (relative) */
-                float x, y;
-                p = parse_float(p, &x);
-                p = parse_float(p, &y);
-                cx += x; cy += y;
-                sx = cx; sy = cy;
-                add_point(tx, ty, &count, cx, cy, max);
-                cmd = 'l';
-                break;
-            }
-            case 'L': { /* Line to (absolute) */
-                float x, y;
-                p = parse_float(p, &x);
-                p = parse_float(p, &y);
-                cx = x; cy = y;
-                add_point(tx, ty, &count, cx, cy, max);
+            case 'l':
+                cx = a[0] + ox; cy = a[1] + oy;
+                add_point(sink, cx, cy);
                 break;
-            }
-            case 'l': { /* Line to (relative) */
-                float x, y;
-                p = parse_float(p, &x);
-                p = parse_float(p, &y);
-                cx += x; cy += y;
-                add_point(tx, ty, &count, cx, cy, max);
+            case 'h':
+                cx = a[0] + ox;
+                add_point(sink, cx, cy);
                 break;
-            }
-            case 'H': { /* Horizontal line (absolute) */
-                float x;
-                p = parse_float(p, &x);
-                cx = x;
-                add_point(tx, ty, &count, cx, cy, max);
+            case 'v':
+                cy = a[0] + oy;
+                add_point(sink, cx, cy);
                 break;
-            }
-            case 'h': { /* Horizontal line (relative) */
-                float x;
-                p = parse_float(p, &x);
-                cx += x;
-                add_point(tx, ty, &count, cx, cy, max);
-                break;
-            }
-            case 'V': { /* Vertical line (absolute) */
-                float y;
-                p = parse_float(p, &y);
-                cy = y;
-                add_point(tx, ty, &count, cx, cy, max);
-                break;
-            }
-            case 'v': { /* Vertical line (relative) */
-                float y;
-                p = parse_float(p, &y);
-                cy += y;
-                add_point(tx, ty, &count, cx, cy, max);
-                break;
-            }
-            case 'C': { /* Cubic bezier (absolute) */
-                float x1, y1, x2, y2, x, y;
-                p = parse_float(p, &x1);
-                p = parse_float(p, &y1);
-                p = parse_float(p, &x2);
-                p = parse_float(p, &y2);
-                p = parse_float(p, &x);
-                p = parse_float(p, &y);
-                cubic_bezier(tx, ty, &count, max, cx, cy, x1, y1, x2, y2, x, y, bezier_steps);
+            case 'c':
+            case 's': {
+                float x1 = 2 * cx - lx, y1 = 2 * cy - ly;
+                if (prev != 'c' && prev != 's') { x1 = cx; y1 = cy; }
+                const float *q = a;
+                if (cmd == 'c') { x1 = a[0] + ox; y1 = a[1] + oy; q = a + 2; }
+                float x2 = q[0] + ox, y2 = q[1] + oy, x = q[2] + ox, y = q[3] + oy;
+                cubic_bezier(sink, cx, cy, x1, y1, x2, y2, x, y);
                 lx = x2; ly = y2;
                 cx = x; cy = y;
                 break;
             }
-            case 'c': { /* Cubic bezier (relative) */
-                float x1, y1, x2, y2, x, y;
-                p = parse_float(p, &x1);
-                p = parse_float(p, &y1);
-                p = parse_float(p, &x2);
-                p = parse_float(p, &y2);
-                p = parse_float(p, &x);
-                p = parse_float(p, &y);
-                cubic_bezier(tx, ty, &count, max, cx, cy, cx+x1, cy+y1, cx+x2, cy+y2, cx+x, cy+y, bezier_steps);
-                lx = cx + x2; ly = cy + y2;
-                cx += x; cy += y;
-                break;
-            }
-            case 'S': { /* Smooth cubic bezier (absolute) */
-                float x2, y2, x, y;
-                p = parse_float(p, &x2);
-                p = parse_float(p, &y2);
-                p = parse_float(p, &x);
-                p = parse_float(p, &y);
-                float x1 = 2*cx - lx, y1 = 2*cy - ly;
-                cubic_bezier(tx, ty, &count, max, cx, cy, x1, y1, x2, y2, x, y, bezier_steps);
-                lx = x2; ly = y2;
-                cx = x; cy = y;
-                break;
-            }
-            case 's': { /* Smooth cubic bezier (relative) */
-                float x2, y2, x, y;
-                p = parse_float(p, &x2);
-                p = parse_float(p, &y2);
-                p = parse_float(p, &x);
-                p = parse_float(p, &y);
-                float x1 = 2*cx - lx, y1 = 2*cy - ly;
-                cubic_bezier(tx, ty, &count, max, cx, cy, x1, y1, cx+x2, cy+y2, cx+x, cy+y, bezier_steps);
-                lx = cx + x2; ly = cy + y2;
-                cx += x; cy += y;
-                break;
-            }
-            case 'Q': { /* Quadratic bezier (absolute) */
-                float x1, y1, x, y;
-                p = parse_float(p, &x1);
-                p = parse_float(p, &y1);
-                p = parse_float(p, &x);
-                p = parse_float(p, &y);
-                quad_bezier(tx, ty, &count, max, cx, cy, x1, y1, x, y, bezier_steps);
+            case 'q':
+            case 't': {
+                float x1 = 2 * cx - lx, y1 = 2 * cy - ly;
+                if (prev != 'q' && prev != 't') { x1 = cx; y1 = cy; }
+                const float *q = a;
+                if (cmd == 'q') { x1 = a[0] + ox; y1 = a[1] + oy; q = a + 2; }
+                float x = q[0] + ox, y = q[1] + oy;
+                quad_bezier(sink, cx, cy, x1, y1, x, y);
                 lx = x1; ly = y1;
                 cx = x; cy = y;
                 break;
             }
-            case 'q': { /* Quadratic bezier (relative) */
-                float x1, y1, x, y;
-                p = parse_float(p, &x1);
-                p = parse_float(p, &y1);
-                p = parse_float(p, &x);
-                p = parse_float(p, &y);
-                quad_bezier(tx, ty, &count, max, cx, cy, cx+x1, cy+y1, cx+x, cy+y, bezier_steps);
-                lx = cx + x1; ly = cy + y1;
-                cx += x; cy += y;
+            case 'a': {
+                float x = a[5] + ox, y = a[6] + oy;
+                arc_to_curves(sink, cx, cy, a[0], a[1], a[2], a[3] != 0.0f, a[4] != 0.0f, x, y);
+                cx = x; cy = y;
                 break;
             }
-            case 'Z':
-            case 'z': { /* Close path */
+            case 'z':
                 if (cx != sx || cy != sy) {
-                    add_point(tx, ty, &count, sx, sy, max);
+                    add_point(sink, sx, sy);
                 }
                 cx = sx; cy = sy;
                 break;
-            }
-            default:
-                p++; /* Skip unknown */
-                break;
         }
+        prev = cmd;
+        commands++;
+    }
+    
+    status->commands += commands;
+    if (error != SVG_PATH_OK && status->error == SVG_PATH_OK) {
+        status->error = error;
+        status->offset = (int)(p - d);
     }
-    return count;
 }
 
-/* Find and extract path data from SVG file content */
-static const char *find_path_d(const char *svg, char *d_out, int max_len) {
-    /* Look for <path with d=" attribute */
-    const char *p = svg;
-    while ((p = strstr(p, "<path")) != NULL) {
-        const char *end = strchr(p, '>');
-        if (!end) break;
-        
-        /* Find d=" within this path element */
-        const char *d = strstr(p, " d=\"");
-        if (!d || d > end) d = strstr(p, " d='");
-        if (!d || d > end) { p = end; continue; }
+/* Records for the curves of about `length` bytes of path data, growing from there */
+static void curve_list_init(curve_list_t *curves, size_t length, mem_arena_t *arena) {
+    /* A curve takes at least 8 characters ("q1 2 3 4"); the cap keeps huge files from reserving it all */
+    size_t hint = length / 8 + 1;
+    curves->data = NULL;
+    curves->count = 0;
+    curves->capacity = 0;
+    curves->hint = hint < 4096 ? (int)hint : 4096;
+    curves->arena = arena;
+}
+
+/* Parse SVG path data into points (appended to out) */
+int parse_svg_path(const char *d, int length, point_list_t *out, float tolerance, svg_path_status_t *status) {
+    int start_count = out->count;
+    curve_list_t curves;
+    curve_list_init(&curves, (size_t)length, out->arena);
+    
+    path_sink_t sink = { out, &curves, identity_matrix };
+    svg_path_status_t local = { SVG_PATH_OK, 0, 0, 0 };
+    parse_path_data(d, length, &sink, &local);
+    if (status) *status = local;
+    if (out->count > start_count) flatten_curves(out, start_count, &curves, tolerance);
+    if (!curves.arena) mem_free(curves.data);
+    return out->count - start_count;
+}
+
+/* ========== SVG READER ========== */
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool is_name_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '_' || c == '-' || c == ':' || c == '.';
+}
+
+static bool name_is(const char *name, size_t len, const char *literal) {
+    return strlen(literal) == len && memcmp(name, literal, len) == 0;
+}
+
+/* Bounded search for seq in [p, end) */
+static const char *find_seq(const char *p, const char *end, const char *seq) {
+    size_t n = strlen(seq);
+    while ((size_t)(end - p) >= n) {
+        p = (const char *)memchr(p, seq[0], (size_t)(end - p) - n + 1);
+        if (!p) return NULL;
+        if (memcmp(p, seq, n) == 0) return p;
+        p++;
+    }
+    return NULL;
+}
+
+/* Containers whose paths are not drawn where they stand (definitions, clips, masks, ...) */
+static bool is_hidden_container(const char *name, size_t len) {
+    return name_is(name, len, "defs") || name_is(name, len, "clipPath") || name_is(name, len, "mask") ||
+           name_is(name, len, "symbol") || name_is(name, len, "marker") || name_is(name, len, "pattern");
+}
+
+/* ========== Transforms ========== */
+
+/* m * n: apply n, then m */
+static svg_matrix_t matrix_multiply(const svg_matrix_t *m, const svg_matrix_t *n) {
+    svg_matrix_t r;
+    r.a = m->a * n->a + m->c * n->b;
+    r.b = m->b * n->a + m->d * n->b;
+    r.c = m->a * n->c + m->c * n->d;
+    r.d = m->b * n->c + m->d * n->d;
+    r.e = m->a * n->e + m->c * n->f + m->e;
+    r.f = m->b * n->e + m->d * n->f + m->f;
+    return r;
+}
+
+/* Blanks and commas between transform items and their arguments */
+static const char *skip_list_sep(const char *p, const char *end) {
+    while (p < end && (is_space(*p) || *p == ',')) p++;
+    return p;
+}
+
+/*
+ * Parse a transform list ("translate(10 20) rotate(45)") into one matrix,
+ * composed left to right. An unparseable list leaves m unchanged and
+ * returns false; the attribute is then ignored, as browsers do.
+ */
+static bool parse_transform(const char *p, const char *end, svg_matrix_t *m) {
+    svg_matrix_t r = identity_matrix;
+    
+    while ((p = skip_list_sep(p, end)) < end) {
+        const char *name = p;
+        while (p < end && ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z'))) p++;
+        size_t name_len = (size_t)(p - name);
+        while (p < end && is_space(*p)) p++;
+        if (p >= end || *p != '(') return false;
+        p++;
         
-        d += 4; /* Skip ' d="' */
-        char quote = *(d - 1);
-        const char *d_end = strchr(d, quote);
-        if (!d_end) { p = end; continue; }
+        float v[6];
+        int n = 0;
+        for (;;) {
+            p = skip_list_sep(p, end);
+            if (p < end && *p == ')') { p++; break; }
+            if (n == 6) return false;
+            const char *q = scan_float(p, end, &v[n]);
+            if (q == p) return false;
+            p = q;
+            n++;
+        }
         
-        int len = (int)(d_end - d);
-        if (len >= max_len) len = max_len - 1;
-        strncpy(d_out, d, len);
-        d_out[len] = '\0';
-        return d_out;
+        svg_matrix_t t = identity_matrix;
+        if (name_is(name, name_len, "matrix") && n == 6) {
+            t.a = v[0]; t.b = v[1]; t.c = v[2]; t.d = v[3]; t.e = v[4]; t.f = v[5];
+        } else if (name_is(name, name_len, "translate") && (n == 1 || n == 2)) {
+            t.e = v[0];
+            t.f = n == 2 ? v[1] : 0.0f;
+        } else if (name_is(name, name_len, "scale") && (n == 1 || n == 2)) {
+            t.a = v[0];
+            t.d = n == 2 ? v[1] : v[0];
+        } else if (name_is(name, name_len, "rotate") && (n == 1 || n == 3)) {
+            double angle = v[0] * (3.14159265358979323846 / 180.0);
+            float cos_a = (float)cos(angle), sin_a = (float)sin(angle);
+            t.a = cos_a; t.b = sin_a; t.c = -sin_a; t.d = cos_a;
+            if (n == 3) {
+                /* About (cx, cy): translate(cx, cy) rotate(a) translate(-cx, -cy) */
+                t.e = v[1] - cos_a * v[1] + sin_a * v[2];
+                t.f = v[2] - sin_a * v[1] - cos_a * v[2];
+            }
+        } else if (name_is(name, name_len, "skewX") && n == 1) {
+            t.c = (float)tan(v[0] * (3.14159265358979323846 / 180.0));
+        } else if (name_is(name, name_len, "skewY") && n == 1) {
+            t.b = (float)tan(v[0] * (3.14159265358979323846 / 180.0));
+        } else {
+            return false;
+        }
+        r = matrix_multiply(&r, &t);
     }
-    return NULL;
+    
+    *m = r;
+    return true;
 }
 
-/* Load shape from an SVG file */
-int load_svg_file(Vector2 *points, const char *filename, float cx, float cy, float scale, int max_points) {
-    FILE *file = fopen(filename, "r");
-    if (!file) {
-        printf("Could not open SVG file: %s\n", filename);
-        return 0;
+/* A length attribute in user units; false if missing or relative to an unknown viewport (%) */
+static bool parse_length(const char *p, size_t len, float *out) {
+    if (!p) return false;
+    const char *end = p + len;
+    p = skip_list_sep(p, end);
+    const char *q = scan_float(p, end, out);
+    if (q == p || *out < 0.0f) return false;
+    return !(q < end && *q == '%');
+}
+
+/* Attributes of an <svg> element that place its contents */
+typedef struct {
+    const char *view_box, *width, *height, *x, *y, *aspect;
+    size_t view_box_len, width_len, height_len, x_len, y_len, aspect_len;
+} svg_viewport_attrs_t;
+
+/*
+ * viewBox to viewport transform of an <svg> element (SVG 1.1, 7.8). A
+ * missing width or height takes the viewBox's, and without a viewBox only
+ * x/y (nested elements) move the contents.
+ */
+static svg_matrix_t viewport_matrix(const svg_viewport_attrs_t *v, bool root) {
+    svg_matrix_t m = identity_matrix;
+    float x = 0.0f, y = 0.0f;
+    if (!root) {
+        parse_length(v->x, v->x_len, &x);
+        parse_length(v->y, v->y_len, &y);
     }
+    m.e = x;
+    m.f = y;
     
-    /* Read entire file */
-    fseek(file, 0, SEEK_END);
-    long fsize = ftell(file);
-    fseek(file, 0, SEEK_SET);
+    float box[4];
+    const char *p = v->view_box;
+    const char *end = p ? p + v->view_box_len : NULL;
+    for (int i = 0; i < 4; i++) {
+        if (!p) return m;
+        p = skip_list_sep(p, end);
+        const char *q = scan_float(p, end, &box[i]);
+        if (q == p) return m;
+        p = q;
+    }
+    if (box[2] <= 0.0f || box[3] <= 0.0f) return m;
     
-    if (fsize > 100000) fsize = 100000; /* Limit file size */
+    float width = box[2], height = box[3];
+    parse_length(v->width, v->width_len, &width);
+    parse_length(v->height, v->height_len, &height);
+    float sx = width / box[2], sy = height / box[3];
     
-    char *svg = (char *)malloc((size_t)fsize + 1);
-    if (!svg) { fclose(file); return 0; }
+    /* preserveAspectRatio: [defer] <none | x{Min,Mid,Max}Y{Min,Mid,Max}> [meet | slice] */
+    int align_x = 1, align_y = 1;   /* 0 = Min, 1 = Mid, 2 = Max */
+    bool none = false, slice = false;
+    if (v->aspect) {
+        const char *a = v->aspect, *a_end = v->aspect + v->aspect_len;
+        a = skip_list_sep(a, a_end);
+        if (a_end - a >= 5 && memcmp(a, "defer", 5) == 0) a = skip_list_sep(a + 5, a_end);
+        if (a_end - a >= 4 && memcmp(a, "none", 4) == 0) {
+            none = true;
+        } else if (a_end - a >= 8 && a[0] == 'x' && a[4] == 'Y') {
+            align_x = memcmp(a + 1, "Min", 3) == 0 ? 0 : memcmp(a + 1, "Max", 3) == 0 ? 2 : 1;
+            align_y = memcmp(a + 5, "Min", 3) == 0 ? 0 : memcmp(a + 5, "Max", 3) == 0 ? 2 : 1;
+            a = skip_list_sep(a + 8, a_end);
+            slice = a_end - a >= 5 && memcmp(a, "slice", 5) == 0;
+        }
+    }
+    if (!none) {
+        float s = slice ? fmaxf(sx, sy) : fminf(sx, sy);
+        sx = sy = s;
+    }
     
-    fread(svg, 1, (size_t)fsize, file);
-    svg[fsize] = '\0';
-    fclose(file);
+    m.a = sx;
+    m.d = sy;
+    m.e = x - box[0] * sx + (width - box[2] * sx) * (float)align_x / 2.0f;
+    m.f = y - box[1] * sy + (height - box[3] * sy) * (float)align_y / 2.0f;
+    return m;
+}
+
+/* ========== Reader ========== */
+
+void svg_reader_init(svg_reader_t *reader, const char *svg, size_t size) {
+    reader->data = svg;
+    reader->size = size;
+    reader->pos = 0;
+    reader->hidden_depth = 0;
+    reader->depth = 0;
+    reader->matrix = identity_matrix;
+}
+
+/* Transform to document space inside the innermost open element */
+static const svg_matrix_t *reader_ctm(const svg_reader_t *reader) {
+    if (reader->depth == 0) return &identity_matrix;
+    return &reader->ctm[(reader->depth < SVG_MAX_DEPTH ? reader->depth : SVG_MAX_DEPTH) - 1];
+}
+
+const char *svg_next_path(svg_reader_t *reader, int *length) {
+    const char *end = reader->data + reader->size;
+    const char *p = reader->data + reader->pos;
+    
+    while (p < end) {
+        p = (const char *)memchr(p, '<', (size_t)(end - p));
+        if (!p) break;
+        p++;
+        
+        /* Comments, CDATA, declarations and processing instructions */
+        if (p < end && (*p == '!' || *p == '?')) {
+            const char *close;
+            if (end - p >= 3 && memcmp(p, "!--", 3) == 0)           close = find_seq(p + 3, end, "-->");
+            else if (end - p >= 8 && memcmp(p, "![CDATA[", 8) == 0) close = find_seq(p + 8, end, "]]>");
+            else                                                     close = (const char *)memchr(p, '>', (size_t)(end - p));
+            if (!close) break;
+            p = close + 1;
+            continue;
+        }
+        
+        bool closing = p < end && *p == '/';
+        if (closing) p++;
+        const char *name = p;
+        while (p < end && is_name_char(*p)) p++;
+        size_t name_len = (size_t)(p - name);
+        
+        /* Match on the local name, so prefixed documents (<svg:path>) load too */
+        const char *colon = (const char *)memchr(name, ':', name_len);
+        if (colon) {
+            name_len -= (size_t)(colon + 1 - name);
+            name = colon + 1;
+        }
+        
+        if (closing) {
+            if (is_hidden_container(name, name_len) && reader->hidden_depth > 0) reader->hidden_depth--;
+            if (reader->depth > 0) reader->depth--;
+            continue;
+        }
+        
+        /* Attributes; values are skipped whole, so a '>' inside quotes does not end the tag */
+        bool is_svg = name_is(name, name_len, "svg");
+        const char *d = NULL;
+        size_t d_len = 0;
+        const char *transform = NULL;
+        size_t transform_len = 0;
+        svg_viewport_attrs_t viewport;
+        memset(&viewport, 0, sizeof(viewport));
+        bool self_closing = false;
+        bool complete = false;
+        while (p < end) {
+            while (p < end && is_space(*p)) p++;
+            if (p >= end) break;
+            if (*p == '>') { p++; complete = true; break; }
+            if (*p == '/') { self_closing = true; p++; continue; }
+            self_closing = false;
+            
+            const char *attr = p;
+            while (p < end && *p != '=' && *p != '>' && *p != '/' && !is_space(*p)) p++;
+            size_t attr_len = (size_t)(p - attr);
+            if (attr_len == 0) { p++; continue; }
+            
+            while (p < end && is_space(*p)) p++;
+            if (p >= end || *p != '=') continue;
+            p++;
+            while (p < end && is_space(*p)) p++;
+            if (p >= end || (*p != '"' && *p != '\'')) continue;
+            
+            const char *value = p + 1;
+            const char *close = (const char *)memchr(value, *p, (size_t)(end - value));
+            if (!close) { p = end; break; }
+            size_t value_len = (size_t)(close - value);
+            if (attr_len == 1 && attr[0] == 'd') {
+                d = value;
+                d_len = value_len;
+            } else if (name_is(attr, attr_len, "transform")) {
+                transform = value;
+                transform_len = value_len;
+            } else if (is_svg) {
+                if      (name_is(attr, attr_len, "viewBox"))             { viewport.view_box = value; viewport.view_box_len = value_len; }
+                else if (name_is(attr, attr_len, "width"))               { viewport.width = value;    viewport.width_len = value_len; }
+                else if (name_is(attr, attr_len, "height"))              { viewport.height = value;   viewport.height_len = value_len; }
+                else if (name_is(attr, attr_len, "x"))                   { viewport.x = value;        viewport.x_len = value_len; }
+                else if (name_is(attr, attr_len, "y"))                   { viewport.y = value;        viewport.y_len = value_len; }
+                else if (name_is(attr, attr_len, "preserveAspectRatio")) { viewport.aspect = value;   viewport.aspect_len = value_len; }
+            }
+            p = close + 1;
+        }
+        if (!complete) break;
+        
+        /* This element's user space: parent's, then its transform, then (for <svg>) its viewport */
+        svg_matrix_t ctm = *reader_ctm(reader);
+        if (transform) {
+            svg_matrix_t t;
+            if (parse_transform(transform, transform + transform_len, &t)) ctm = matrix_multiply(&ctm, &t);
+        }
+        if (is_svg) {
+            svg_matrix_t v = viewport_matrix(&viewport, reader->depth == 0);
+            ctm = matrix_multiply(&ctm, &v);
+        }
+        if (!self_closing) {
+            if (reader->depth < SVG_MAX_DEPTH) reader->ctm[reader->depth] = ctm;
+            reader->depth++;
+        }
+        
+        if (is_hidden_container(name, name_len)) {
+            if (!self_closing) reader->hidden_depth++;
+        } else if ((name_is(name, name_len, "script") || name_is(name, name_len, "style")) && !self_closing) {
+            /* Raw text: a '<' in there is not markup */
+            const char *close = find_seq(p, end, name_is(name, name_len, "script") ? "</script" : "</style");
+            if (!close) break;
+            p = close;
+        } else if (name_is(name, name_len, "path") && d && reader->hidden_depth == 0 && d_len <= (size_t)0x7fffffff) {
+            reader->pos = (size_t)(p - reader->data);
+            reader->matrix = ctm;
+            *length = (int)d_len;
+            return d;
+        }
+    }
     
-    /* Extract path data */
-    char *path_d = (char *)malloc((size_t)fsize + 1);
-    if (!path_d) { free(svg); return 0; }
+    reader->pos = reader->size;
+    return NULL;
+}
+
+/* Flatten every drawn path of a document (appended to out); bounds receives those of the
+ * added points when there are any */
+static int parse_document(const char *svg, size_t size, point_list_t *out, float tolerance, int *paths,
+                          svg_path_status_t *status, bounds_t *bounds) {
+    /* Paths are concatenated in document order into one tour (closed by the transform);
+     * curves are flattened together, against the size of the whole drawing */
+    int first = out->count;
+    curve_list_t curves;
+    curve_list_init(&curves, size, out->arena);
+    path_sink_t sink = { out, &curves, identity_matrix };
     
-    if (!find_path_d(svg, path_d, (int)fsize)) {
-        printf("No path found in SVG: %s\n", filename);
-        free(svg);
-        free(path_d);
-        return 0;
+    svg_reader_t reader;
+    svg_reader_init(&reader, svg, size);
+    svg_path_status_t local = { SVG_PATH_OK, 0, 0, 0 };
+    int found = 0;
+    int d_len = 0;
+    const char *d;
+    while ((d = svg_next_path(&reader, &d_len)) != NULL) {
+        bool clean = local.error == SVG_PATH_OK;
+        sink.m = reader.matrix;
+        parse_path_data(d, d_len, &sink, &local);
+        if (clean && local.error != SVG_PATH_OK) {
+            /* Report the first error against the document, not the path */
+            local.offset += (int)(d - svg);
+            local.path = found;
+        }
+        found++;
     }
+    if (status) *status = local;
+    if (out->count > first) *bounds = flatten_curves(out, first, &curves, tolerance);
+    if (!curves.arena) mem_free(curves.data);
     
-    /* Parse path into temporary arrays */
-    float *temp_x = (float *)malloc((size_t)max_points * sizeof(float));
-    float *temp_y = (float *)malloc((size_t)max_points * sizeof(float));
-    if (!temp_x || !temp_y) {
-        free(svg); free(path_d);
-        if (temp_x) free(temp_x);
-        if (temp_y) free(temp_y);
+    if (paths) *paths = found;
+    return out->count - first;
+}
+
+int parse_svg_document(const char *svg, size_t size, point_list_t *out, float tolerance, int *paths,
+                       svg_path_status_t *status) {
+    bounds_t bounds;
+    return parse_document(svg, size, out, tolerance, paths, status, &bounds);
+}
+
+/* Load shape from an SVG file */
+int load_svg_file(point_list_t *points, const char *filename, float cx, float cy, float scale) {
+    /* Mapped, not read: path data is parsed in place, so no copy of the file is ever made */
+    platform_file_map_t map;
+    if (!platform_map_file(filename, &map)) {
+        fprintf(stderr, "Could not open SVG file: %s\n", filename);
         return 0;
     }
     
-    int count = parse_svg_path(path_d, temp_x, temp_y, max_points);
-    
-    free(svg);
-    free(path_d);
+    int first = points->count;
+    int paths = 0;
+    svg_path_status_t status;
+    bounds_t bounds;
+    parse_document(map.data, map.size, points, flatten_tolerance / scale, &paths, &status, &bounds);
     
-    if (count == 0) {
-        free(temp_x);
-        free(temp_y);
-        return 0;
+    if (status.error != SVG_PATH_OK) {
+        /* Line and column of the first error, for fixing the file by hand */
+        int line = 1, column = 1;
+        for (int i = 0; i < status.offset; i++) {
+            if (map.data[i] == '\n') { line++; column = 1; } else column++;
+        }
+        fprintf(stderr, "SVG path %d: %s at line %d, column %d (rest of the path skipped): %s\n",
+                status.path + 1, svg_path_error_string(status.error), line, column, filename);
     }
+    platform_unmap_file(&map);
     
-    /* Find bounding box */
-    float min_x = temp_x[0], max_x = temp_x[0];
-    float min_y = temp_y[0], max_y = temp_y[0];
-    for (int i = 1; i < count; i++) {
-        if (temp_x[i] < min_x) min_x = temp_x[i];
-        if (temp_x[i] > max_x) max_x = temp_x[i];
-        if (temp_y[i] < min_y) min_y = temp_y[i];
-        if (temp_y[i] > max_y) max_y = temp_y[i];
+    if (paths == 0) {
+        fprintf(stderr, "No path found in SVG: %s\n", filename);
+        return 0;
     }
+    int count = points->count - first;
+    if (count == 0) return 0;
+    /* Transforms were applied as the points were made and the bounds gathered while flattening,
+     * so centering and scaling is the only other pass over the points */
+    fit_to_bounds(points, first, &bounds, cx, cy, scale);
     
-    /* Center and scale */
-    float orig_cx = (min_x + max_x) / 2.0f;
-    float orig_cy = (min_y + max_y) / 2.0f;
-    float width = max_x - min_x;
-    float height = max_y - min_y;
-    float max_dim = (width > height) ? width : height;
-    float s = (max_dim > 0) ? (scale / max_dim) : 1.0f;
-    
-    for (int i = 0; i < count; i++) {
-        points[i].x = cx + (temp_x[i] - orig_cx) * s;
-        points[i].y = cy + (temp_y[i] - orig_cy) * s;
+    if (shapes_verbose) {
+        fprintf(stderr, "Loaded %d points from %d path%s in SVG: %s\n", count, paths, paths == 1 ? "" : "s", filename);
     }
-    
-    free(temp_x);
-    free(temp_y);
-    
-    printf("Loaded %d points from SVG: %s\n", count, filename);
     return count;
 }
@@ -0,0 +1,191 @@
+/**
+ * task_pool.c - Work-Stealing Task Pool Implementation
+ *
+ * Each loop gets one queue per thread: a contiguous run of chunks with an
+ * atomic cursor. Owners and thieves claim chunks with the same atomic add
+ * on the cursor, so a chunk is handed out exactly once without a lock.
+ */
+
+#include "task_pool.h"
+#include "platform.h"
+
+/* ========== Types ========== */
+
+typedef struct {
+    volatile int next;          /* First unclaimed index */
+    int end;
+    char pad[64 - 2 * sizeof(int)];     /* One queue per cache line */
+} task_queue_t;
+
+/* ========== State ========== */
+
+/* Guards worker start/stop and the job handoff below */
+static platform_mutex_t pool_lock = PLATFORM_MUTEX_INIT;
+static platform_cond_t job_ready = PLATFORM_COND_INIT;
+static platform_cond_t job_done = PLATFORM_COND_INIT;
+
+static platform_thread_t *workers[TASK_POOL_MAX_THREADS];
+static int worker_ids[TASK_POOL_MAX_THREADS];
+static int worker_count = 0;            /* Running workers, caller not included */
+static unsigned start_generation = 0;   /* Last loop issued before the workers started */
+static bool quitting = false;
+
+static volatile int requested_threads = 0;
+static volatile int busy = 0;           /* A loop is running */
+
+/* Current loop */
+static task_pool_fn job_fn;
+static void *job_ctx;
+static int job_grain;
+static int job_threads;
+static unsigned job_generation = 0;
+static int job_active = 0;              /* Workers that have not finished the loop yet */
+static task_queue_t queues[TASK_POOL_MAX_THREADS];
+
+/* ========== Work Loop ========== */
+
+/* Drain the own queue first, then steal from the others in turn */
+static void work(int id)
+{
+    for (int v = 0; v < job_threads; v++) {
+        task_queue_t *q = &queues[(id + v) % job_threads];
+
+        for (;;) {
+            int begin = platform_atomic_add(&q->next, job_grain) - job_grain;
+            if (begin >= q->end) break;
+            int end = begin + job_grain < q->end ? begin + job_grain : q->end;
+            job_fn(job_ctx, begin, end);
+        }
+    }
+}
+
+static void worker_main(void *arg)
+{
+    int id = *(int *)arg;
+    unsigned seen = start_generation;
+
+    platform_mutex_lock(&pool_lock);
+    for (;;) {
+        while (!quitting && job_generation == seen) {
+            platform_cond_wait(&job_ready, &pool_lock);
+        }
+        if (quitting) break;
+        seen = job_generation;
+
+        bool participate = id < job_threads;
+        platform_mutex_unlock(&pool_lock);
+        if (participate) work(id);
+        platform_mutex_lock(&pool_lock);
+
+        if (--job_active == 0) platform_cond_broadcast(&job_done);
+    }
+    platform_mutex_unlock(&pool_lock);
+}
+
+/* ========== Workers ========== */
+
+static void stop_workers(void)
+{
+    platform_mutex_lock(&pool_lock);
+    quitting = true;
+    platform_cond_broadcast(&job_ready);
+    platform_mutex_unlock(&pool_lock);
+
+    for (int i = 0; i < worker_count; i++) {
+        platform_thread_join(workers[i]);
+        workers[i] = NULL;
+    }
+    worker_count = 0;
+    quitting = false;
+}
+
+/* Bring the pool to `count` workers; returns how many are running */
+static int ensure_workers(int count)
+{
+    if (worker_count == count) return worker_count;
+    if (worker_count > 0) stop_workers();
+
+    start_generation = job_generation;
+    for (int i = 0; i < count; i++) {
+        worker_ids[i] = i + 1;      /* Queue 0 belongs to the calling thread */
+        workers[i] = platform_thread_start(worker_main, &worker_ids[i]);
+        if (!workers[i]) break;
+        worker_count++;
+    }
+    return worker_count;
+}
+
+/* ========== Public API ========== */
+
+void task_pool_set_threads(int threads)
+{
+    platform_atomic_store(&requested_threads, threads > 0 ? threads : 0);
+}
+
+int task_pool_threads(void)
+{
+    int threads = platform_atomic_load(&requested_threads);
+    if (threads <= 0) threads = platform_cpu_count();
+    if (threads > TASK_POOL_MAX_THREADS) threads = TASK_POOL_MAX_THREADS;
+    return threads > 0 ? threads : 1;
+}
+
+bool task_pool_run(int count, int grain, task_pool_fn fn, void *ctx)
+{
+    if (count <= 0) return false;
+    if (grain < 1) grain = 1;
+
+    int chunks = (count + grain - 1) / grain;
+    int threads = task_pool_threads();
+    if (threads > chunks) threads = chunks;
+
+    /* Busy pool (another loop, or a nested call from a task): run on the caller */
+    if (threads > 1 && platform_atomic_add(&busy, 1) != 1) {
+        platform_atomic_add(&busy, -1);
+        threads = 1;
+    }
+    if (threads <= 1) {
+        fn(ctx, 0, count);
+        return false;
+    }
+
+    int running = ensure_workers(task_pool_threads() - 1);
+    if (threads > running + 1) threads = running + 1;
+    if (threads <= 1) {
+        platform_atomic_add(&busy, -1);
+        fn(ctx, 0, count);
+        return false;
+    }
+
+    platform_mutex_lock(&pool_lock);
+    job_fn = fn;
+    job_ctx = ctx;
+    job_grain = grain;
+    job_threads = threads;
+    for (int i = 0; i < threads; i++) {
+        queues[i].next = (int)((long long)chunks * i / threads) * grain;
+        int end = (int)((long long)chunks * (i + 1) / threads) * grain;
+        queues[i].end = end < count ? end : count;
+    }
+    job_active = worker_count;
+    job_generation++;
+    platform_cond_broadcast(&job_ready);
+    platform_mutex_unlock(&pool_lock);
+
+    work(0);
+
+    /* Every worker checks in, so nothing still reads the job once this returns */
+    platform_mutex_lock(&pool_lock);
+    while (job_active > 0) {
+        platform_cond_wait(&job_done, &pool_lock);
+    }
+    platform_mutex_unlock(&pool_lock);
+
+    platform_atomic_add(&busy, -1);
+    return true;
+}
+
+void task_pool_shutdown(void)
+{
+    if (worker_count > 0) stop_workers();
+}
@@ -19,9 +19,14 @@ bool draw_button(int x, int y, int w, int h, const char *text, Color bg, Color h
 }
 
 float draw_slider(int x, int y, int w, float value, float min_val, float max_val, const char *label) {
+    return draw_slider_ex(x, y, w, value, min_val, max_val, label, "%.2fx");
+}
+
+float draw_slider_ex(int x, int y, int w, float value, float min_val, float max_val,
+                     const char *label, const char *fmt) {
     /* Label */
     DrawText(label, x, y - 20, 14, COLOR_LABEL);
-    DrawText(TextFormat("%.2fx", value), x + w - 45, y - 20, 14, COLOR_VALUE);
+    DrawText(TextFormat(fmt, value), x + w - 45, y - 20, 14, COLOR_VALUE);
     
     /* Track */
     Rectangle track = { (float)x, (float)y + 5, (float)w, 8.0f };